@@ -247,6 +247,40 @@ static bool reorderFieldsInInitListExpr(
   return true;
 }
 
+bool reorderFields(const RecordDecl *Definition,
+                   ArrayRef<unsigned> NewFieldsOrder, ASTContext &Context,
+                   std::map<std::string, tooling::Replacements> &Replacements) {
+  if (!reorderFieldsInDefinition(Definition, NewFieldsOrder, Context,
+                                 Replacements))
+    return false;
+
+  // CXXRD will be nullptr if C code (not C++) is being processed.
+  const CXXRecordDecl *CXXRD = dyn_cast<CXXRecordDecl>(Definition);
+  if (CXXRD)
+    for (const auto *C : CXXRD->ctors())
+      if (const auto *D = dyn_cast<CXXConstructorDecl>(C->getDefinition()))
+        reorderFieldsInConstructor(cast<const CXXConstructorDecl>(D),
+                                   NewFieldsOrder, Context, Replacements);
+
+  // We only need to reorder init list expressions for
+  // plain C structs or C++ aggregate types.
+  // For other types the order of constructor parameters is used,
+  // which we don't change at the moment.
+  // Now (v0) partial initialization is not supported.
+  if (!CXXRD || CXXRD->isAggregate())
+    for (auto Result :
+         match(initListExpr(hasType(equalsNode(Definition)))
+                   .bind("initListExpr"),
+               Context))
+      if (!reorderFieldsInInitListExpr(
+              Result.getNodeAs<InitListExpr>("initListExpr"), NewFieldsOrder,
+              Context, Replacements)) {
+        Replacements.clear();
+        return false;
+      }
+  return true;
+}
+
 namespace {
 class ReorderingConsumer : public ASTConsumer {
   StringRef RecordName;
@@ -271,32 +305,7 @@ public:
         getNewFieldsOrder(RD, DesiredFieldsOrder);
     if (NewFieldsOrder.empty())
       return;
-    if (!reorderFieldsInDefinition(RD, NewFieldsOrder, Context, Replacements))
-      return;
-
-    // CXXRD will be nullptr if C code (not C++) is being processed.
-    const CXXRecordDecl *CXXRD = dyn_cast<CXXRecordDecl>(RD);
-    if (CXXRD)
-      for (const auto *C : CXXRD->ctors())
-        if (const auto *D = dyn_cast<CXXConstructorDecl>(C->getDefinition()))
-          reorderFieldsInConstructor(cast<const CXXConstructorDecl>(D),
-                                     NewFieldsOrder, Context, Replacements);
-
-    // We only need to reorder init list expressions for
-    // plain C structs or C++ aggregate types.
-    // For other types the order of constructor parameters is used,
-    // which we don't change at the moment.
-    // Now (v0) partial initialization is not supported.
-    if (!CXXRD || CXXRD->isAggregate())
-      for (auto Result :
-           match(initListExpr(hasType(equalsNode(RD))).bind("initListExpr"),
-                 Context))
-        if (!reorderFieldsInInitListExpr(
-                Result.getNodeAs<InitListExpr>("initListExpr"), NewFieldsOrder,
-                Context, Replacements)) {
-          Replacements.clear();
-          return;
-        }
+    reorderFields(RD, NewFieldsOrder, Context, Replacements);
   }
 };
 } // end anonymous namespace
@@ -19,9 +19,21 @@
 
 namespace clang {
 class ASTConsumer;
+class ASTContext;
+class RecordDecl;
 
 namespace reorder_fields {
 
+/// Moves the field at position \p NewFieldsOrder[i] of \p Definition to
+/// position i, in the definition, in the constructor initializers and in the
+/// brace initializations of the record.
+///
+/// \returns false if the fields cannot be reordered, e.g. because a brace
+/// initialization only initializes some of them.
+bool reorderFields(const RecordDecl *Definition,
+                   ArrayRef<unsigned> NewFieldsOrder, ASTContext &Context,
+                   std::map<std::string, tooling::Replacements> &Replacements);
+
 class ReorderFieldsAction {
   llvm::StringRef RecordName;
   llvm::ArrayRef<std::string> DesiredFieldsOrder;
@@ -186,6 +186,11 @@ protected:
   StringRef getCurrentMainFile() const { return Context->getCurrentFile(); }
   /// Returns the language options from the context.
   const LangOptions &getLangOpts() const { return Context->getLangOpts(); }
+  /// Returns the instance of \p T shared by all checks running on the current
+  /// translation unit.
+  template <typename T> T &getTranslationUnitAnalysis() const {
+    return Context->getTranslationUnitAnalysis<T>();
+  }
 };
 
 } // namespace tidy
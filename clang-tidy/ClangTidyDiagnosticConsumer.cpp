@@ -181,6 +181,7 @@ void ClangTidyContext::setCurrentFile(StringRef File) {
 void ClangTidyContext::setASTContext(ASTContext *Context) {
   DiagEngine->SetArgToStringFn(&FormatASTNodeDiagnosticArgument, Context);
   LangOpts = Context->getLangOpts();
+  TranslationUnitAnalyses.clear();
 }
 
 const ClangTidyGlobalOptions &ClangTidyContext::getGlobalOptions() const {
@@ -114,6 +114,19 @@ public:
   /// Gets the language options from the AST context.
   const LangOptions &getLangOpts() const { return LangOpts; }
 
+  /// Returns the instance of \p T shared by all checks running on the current
+  /// translation unit, default-constructing it on the first request.
+  ///
+  /// This lets several checks reuse an expensive whole-translation-unit
+  /// analysis. The instances are destroyed by \c setASTContext.
+  template <typename T> T &getTranslationUnitAnalysis() {
+    std::unique_ptr<TranslationUnitAnalysis> &Analysis =
+        TranslationUnitAnalyses[&TranslationUnitAnalysisOf<T>::ID];
+    if (!Analysis)
+      Analysis = std::make_unique<TranslationUnitAnalysisOf<T>>();
+    return static_cast<TranslationUnitAnalysisOf<T> &>(*Analysis).Value;
+  }
+
   /// Returns the name of the clang-tidy check which produced this
   /// diagnostic ID.
   std::string getCheckName(unsigned DiagnosticID) const;
@@ -192,6 +205,17 @@ private:
 
   LangOptions LangOpts;
 
+  struct TranslationUnitAnalysis {
+    virtual ~TranslationUnitAnalysis() = default;
+  };
+  template <typename T>
+  struct TranslationUnitAnalysisOf : TranslationUnitAnalysis {
+    static char ID;
+    T Value;
+  };
+  llvm::DenseMap<const void *, std::unique_ptr<TranslationUnitAnalysis>>
+      TranslationUnitAnalyses;
+
   ClangTidyStats Stats;
 
   std::string CurrentBuildDirectory;
@@ -204,6 +228,9 @@ private:
   bool AllowEnablingAnalyzerAlphaCheckers;
 };
 
+template <typename T>
+char ClangTidyContext::TranslationUnitAnalysisOf<T>::ID = 0;
+
 /// Check whether a given diagnostic should be suppressed due to the presence
 /// of a "NOLINT" suppression comment.
 /// This is exposed so that other tools that present clang-tidy diagnostics
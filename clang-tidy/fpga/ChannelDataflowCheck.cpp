@@ -0,0 +1,296 @@
+//===--- ChannelDataflowCheck.cpp - clang-tidy ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ChannelDataflowCheck.h"
+#include "UnrollLoopsCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/KernelClassifier.h"
+#include "../utils/LexerUtils.h"
+#include "../utils/LoopUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/Support/MathExtras.h"
+#include <functional>
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+bool isConditional(const Stmt *S) {
+  if (isa<IfStmt>(S) || isa<SwitchStmt>(S) ||
+      isa<AbstractConditionalOperator>(S))
+    return true;
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(S))
+    return BinOp->isLogicalOp();
+  return false;
+}
+
+/// Returns the channel variable or pipe parameter that \p E refers to. An
+/// element of an array of channels is attributed to the whole array.
+const VarDecl *getChannel(const Expr *E) {
+  E = E->IgnoreParenImpCasts();
+  while (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(E))
+    E = Subscript->getBase()->IgnoreParenImpCasts();
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E))
+    return dyn_cast<VarDecl>(Ref->getDecl());
+  return nullptr;
+}
+
+llvm::Optional<uint64_t> sum(llvm::Optional<uint64_t> LHS,
+                             llvm::Optional<uint64_t> RHS) {
+  if (!LHS || !RHS)
+    return llvm::None;
+  return llvm::SaturatingAdd(*LHS, *RHS);
+}
+
+} // namespace
+
+void ChannelDataflowCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(
+                                       "read_channel_intel",
+                                       "read_channel_nb_intel",
+                                       "write_channel_intel",
+                                       "write_channel_nb_intel",
+                                       "read_channel_altera",
+                                       "read_channel_nb_altera",
+                                       "write_channel_altera",
+                                       "write_channel_nb_altera", "read_pipe",
+                                       "write_pipe"))
+                          .bind("callee")),
+               hasAncestor(functionDecl(isDefinition(),
+                                        hasAttr(attr::Kind::OpenCLKernel))
+                               .bind("kernel")))
+          .bind("call"),
+      this);
+}
+
+void ChannelDataflowCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Call = Result.Nodes.getNodeAs<CallExpr>("call");
+  const auto *Callee = Result.Nodes.getNodeAs<FunctionDecl>("callee");
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+  const SourceManager &SM = *Result.SourceManager;
+  if (Call->getNumArgs() == 0)
+    return;
+  const VarDecl *Var = getChannel(Call->getArg(0));
+  if (!Var)
+    return;
+  const bool IsPipe = isa<ParmVarDecl>(Var) && Var->getType()->isPipeType();
+  if (!IsPipe && !Var->hasGlobalStorage())
+    return;
+
+  Channel &C = Channels[Var->getName()];
+  if (!C.Decl) {
+    C.Decl = Var;
+    C.IsPipe = IsPipe;
+  }
+  // Each end of a pipe may declare its depth.
+  if (llvm::Optional<uint64_t> Depth = utils::lexer::getAttributeArgument(
+          Var, "depth", SM, Context.getLangOpts())) {
+    C.Depth = C.Depth ? std::max(*C.Depth, *Depth) : *Depth;
+  } else if (C.DepthLoc.isInvalid() && !Var->getEndLoc().isMacroID()) {
+    C.DepthLoc = Lexer::getLocForEndOfToken(Var->getEndLoc(), 0, SM,
+                                            Context.getLangOpts());
+  }
+
+  ChannelAccess Access;
+  Access.Kernel = Kernel;
+  Access.IsSingleWorkItem =
+      getTranslationUnitAnalysis<utils::KernelClassifier>()
+          .classify(Kernel, Context)
+          .Model == utils::KernelClassifier::SingleWorkItem;
+  // OpenCL pipes only block if they are declared so, as in the Intel FPGA
+  // SDK for OpenCL.
+  Access.IsBlocking =
+      IsPipe ? utils::lexer::hasAttribute(Var, "blocking", SM,
+                                          Context.getLangOpts())
+             : !Callee->getName().contains("_nb_");
+
+  llvm::Optional<uint64_t> PerIteration = 1;
+  llvm::Optional<uint64_t> PerInvocation = 1;
+  bool InLoop = false;
+  ast_type_traits::DynTypedNode Node =
+      ast_type_traits::DynTypedNode::create(*Call);
+  while (true) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() || Parents[0].get<FunctionDecl>())
+      break;
+    Node = Parents[0];
+    const auto *S = Node.get<Stmt>();
+    if (!S)
+      continue;
+    if (isConditional(S)) {
+      PerInvocation = llvm::None;
+      continue;
+    }
+    if (!utils::isLoop(S))
+      continue;
+    llvm::Optional<uint64_t> TripCount = utils::getTripCount(S, Context);
+    PerInvocation = PerInvocation && TripCount
+                        ? llvm::SaturatingMultiply(*PerInvocation, *TripCount)
+                        : llvm::Optional<uint64_t>();
+    if (InLoop)
+      continue;
+    // Fully unrolled loops and the unrolled copies of the innermost pipelined
+    // loop transfer their items in the same iteration.
+    llvm::Optional<uint64_t> Factor =
+        UnrollLoopsCheck::getUnrollFactor(S, &Context);
+    PerIteration = PerIteration && Factor
+                       ? llvm::SaturatingMultiply(*PerIteration, *Factor)
+                       : llvm::Optional<uint64_t>();
+    InLoop = UnrollLoopsCheck::unrollType(S, &Context) !=
+             UnrollLoopsCheck::FullyUnrolled;
+  }
+  Access.PerIteration = PerIteration;
+  Access.PerInvocation = PerInvocation;
+
+  const StringRef Name = Callee->getName();
+  if (Name.startswith("write"))
+    C.Writes.push_back(Access);
+  else
+    C.Reads.push_back(Access);
+}
+
+void ChannelDataflowCheck::checkRates(const Channel &C) {
+  // The number of work-items of an NDRange kernel is only known at run time,
+  // so its rates cannot be compared with those of the other end.
+  auto IsNDRange = [](const ChannelAccess &Access) {
+    return !Access.IsSingleWorkItem;
+  };
+  if (llvm::any_of(C.Writes, IsNDRange) || llvm::any_of(C.Reads, IsNDRange))
+    return;
+
+  // Items that are written but never read fill the channel until the producer
+  // blocks, and items that are read but never written block the consumer.
+  llvm::Optional<uint64_t> Written = 0;
+  for (const ChannelAccess &Access : C.Writes)
+    Written = sum(Written, Access.PerInvocation);
+  llvm::Optional<uint64_t> Read = 0;
+  for (const ChannelAccess &Access : C.Reads)
+    Read = sum(Read, Access.PerInvocation);
+  const uint64_t Depth = C.Depth.getValueOr(0);
+  if (Written && Read &&
+      (*Read > *Written || *Written > llvm::SaturatingAdd(*Read, Depth))) {
+    diag(C.Decl->getLocation(),
+         "%select{channel|pipe}0 %1 is written %2 times but read %3 times per "
+         "kernel invocation, which blocks the %select{consumer|producer}4 "
+         "forever")
+        << C.IsPipe << C.Decl << static_cast<unsigned>(*Written)
+        << static_cast<unsigned>(*Read) << (*Written > *Read);
+    return;
+  }
+
+  // A producer that writes more items per loop iteration than the consumer
+  // reads, or the other way around, stalls unless the channel can hold the
+  // items of a whole iteration.
+  uint64_t WritesPerIteration = 0;
+  for (const ChannelAccess &Access : C.Writes)
+    if (Access.PerIteration)
+      WritesPerIteration = std::max(WritesPerIteration, *Access.PerIteration);
+  uint64_t ReadsPerIteration = 0;
+  for (const ChannelAccess &Access : C.Reads)
+    if (Access.PerIteration)
+      ReadsPerIteration = std::max(ReadsPerIteration, *Access.PerIteration);
+  const uint64_t Needed = std::max(WritesPerIteration, ReadsPerIteration);
+  if (WritesPerIteration == 0 || ReadsPerIteration == 0 ||
+      WritesPerIteration == ReadsPerIteration || Depth >= Needed)
+    return;
+  auto Diag = diag(C.Decl->getLocation(),
+                   "%select{channel|pipe}0 %1 has a depth of %2, but the "
+                   "producer writes %3 item%s3 and the consumer reads %4 "
+                   "item%s4 per loop iteration; declare it with a depth of at "
+                   "least %5 to avoid stalling the pipeline")
+              << C.IsPipe << C.Decl << static_cast<unsigned>(Depth)
+              << static_cast<unsigned>(WritesPerIteration)
+              << static_cast<unsigned>(ReadsPerIteration)
+              << static_cast<unsigned>(Needed);
+  if (!C.Depth && C.DepthLoc.isValid())
+    Diag << FixItHint::CreateInsertion(
+        C.DepthLoc,
+        (" __attribute__((depth(" + llvm::Twine(Needed) + ")))").str());
+}
+
+void ChannelDataflowCheck::checkCycles() {
+  // The kernels, in the order of their first channel access, and the
+  // channels through which each kernel blocks on another one.
+  llvm::MapVector<const FunctionDecl *,
+                  llvm::SmallVector<std::pair<const FunctionDecl *,
+                                              const Channel *>,
+                                    4>>
+      Successors;
+  for (const auto &Entry : Channels) {
+    const Channel &C = Entry.second;
+    for (const ChannelAccess &Write : C.Writes) {
+      Successors[Write.Kernel];
+      for (const ChannelAccess &Read : C.Reads) {
+        Successors[Read.Kernel];
+        if (!Write.IsBlocking || !Read.IsBlocking)
+          continue;
+        auto &Edges = Successors[Write.Kernel];
+        if (llvm::find(Edges, std::make_pair(Read.Kernel, &C)) == Edges.end())
+          Edges.push_back({Read.Kernel, &C});
+      }
+    }
+  }
+
+  // Report the cycle closed by each back edge of a depth-first search.
+  enum Color { White, Gray, Black };
+  llvm::DenseMap<const FunctionDecl *, Color> Colors;
+  llvm::SmallVector<std::pair<const FunctionDecl *, const Channel *>, 8> Path;
+  std::function<void(const FunctionDecl *)> Visit =
+      [&](const FunctionDecl *Kernel) {
+        Colors[Kernel] = Gray;
+        for (const auto &Edge : Successors[Kernel]) {
+          Path.push_back({Kernel, Edge.second});
+          if (Colors[Edge.first] == White) {
+            Visit(Edge.first);
+          } else if (Colors[Edge.first] == Gray) {
+            auto Start = llvm::find_if(Path, [&](const auto &Step) {
+              return Step.first == Edge.first;
+            });
+            std::string Kernels;
+            std::string Names;
+            for (auto Step = Start; Step != Path.end(); ++Step) {
+              Kernels += "'" + Step->first->getName().str() + "' -> ";
+              if (!Names.empty())
+                Names += ", ";
+              Names += "'" + Step->second->Decl->getName().str() + "'";
+            }
+            Kernels += "'" + Edge.first->getName().str() + "'";
+            diag(Start->second->Decl->getLocation(),
+                 "kernels %0 form a cycle of blocking accesses through %1; it "
+                 "deadlocks if a channel in the cycle fills up, unless the "
+                 "channel depths cover all the items in flight")
+                << Kernels << Names;
+          }
+          Path.pop_back();
+        }
+        Colors[Kernel] = Black;
+      };
+  for (const auto &Entry : Successors)
+    if (Colors[Entry.first] == White)
+      Visit(Entry.first);
+}
+
+void ChannelDataflowCheck::onEndOfTranslationUnit() {
+  for (const auto &Entry : Channels)
+    if (!Entry.second.Writes.empty() && !Entry.second.Reads.empty())
+      checkRates(Entry.second);
+  checkCycles();
+  Channels.clear();
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,74 @@
+//===--- ChannelDataflowCheck.h - clang-tidy --------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_CHANNELDATAFLOWCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_CHANNELDATAFLOWCHECK_H
+
+#include "../ClangTidy.h"
+#include "llvm/ADT/MapVector.h"
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Builds the graph of the kernels of a translation unit that communicate
+/// through Intel channels or OpenCL pipes, and finds channels that are read
+/// and written a different number of times, channels that are too shallow
+/// for the rates of their producers and consumers, and cycles of blocking
+/// accesses that may deadlock.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-channel-dataflow.html
+class ChannelDataflowCheck : public ClangTidyCheck {
+public:
+  ChannelDataflowCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void onEndOfTranslationUnit() override;
+
+private:
+  /// A call that reads or writes a channel.
+  struct ChannelAccess {
+    const FunctionDecl *Kernel;
+    /// The number of items transferred per iteration of the innermost
+    /// pipelined loop around the call, after unrolling.
+    llvm::Optional<uint64_t> PerIteration;
+    /// The number of items transferred per kernel invocation, if the call is
+    /// not conditional and the trip counts of its loops are known.
+    llvm::Optional<uint64_t> PerInvocation;
+    bool IsBlocking;
+    /// The rates of a kernel are only known per invocation if it runs as a
+    /// single work-item; an NDRange kernel is invoked once per work-item.
+    bool IsSingleWorkItem;
+  };
+
+  struct Channel {
+    /// The channel variable, or the first pipe parameter with this name.
+    const NamedDecl *Decl = nullptr;
+    bool IsPipe = false;
+    llvm::Optional<uint64_t> Depth;
+    /// Where to add a depth attribute, if the declaration has none.
+    SourceLocation DepthLoc;
+    llvm::SmallVector<ChannelAccess, 4> Reads;
+    llvm::SmallVector<ChannelAccess, 4> Writes;
+  };
+
+  void checkRates(const Channel &C);
+  void checkCycles();
+
+  /// Pipes are connected by the names of the kernel parameters, and channels
+  /// by their program-scope declaration, whose name is unique.
+  llvm::MapVector<StringRef, Channel> Channels;
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_CHANNELDATAFLOWCHECK_H
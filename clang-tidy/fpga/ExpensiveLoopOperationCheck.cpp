@@ -0,0 +1,217 @@
+//===--- ExpensiveLoopOperationCheck.cpp - clang-tidy ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ExpensiveLoopOperationCheck.h"
+#include "UnrollLoopsCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LoopUtils.h"
+#include "../utils/OptionsUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <tuple>
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+bool isDouble(QualType Type) {
+  return Type->isSpecificBuiltinType(BuiltinType::Double);
+}
+
+bool isPowerOfTwo(const Expr *E, const ASTContext &Context) {
+  const llvm::Optional<int64_t> Value = utils::evaluateInteger(E, Context);
+  return Value && *Value > 0 && llvm::isPowerOf2_64(*Value);
+}
+
+} // namespace
+
+ExpensiveLoopOperationCheck::ExpensiveLoopOperationCheck(
+    StringRef Name, ClangTidyContext *Context)
+    : ClangTidyCheck(Name, Context),
+      RawOperationCosts(Options.get("OperationCosts", "")) {
+  for (unsigned Kind = 0; Kind != utils::NumOperationKinds; ++Kind)
+    OperationCosts[Kind] =
+        utils::getOperationCost(static_cast<utils::OperationKind>(Kind));
+  // Entries are written as "kind:dsps:latency"; malformed ones are ignored.
+  for (StringRef Entry : utils::options::parseStringList(RawOperationCosts)) {
+    StringRef Name, DSPs, Latency;
+    std::tie(Name, DSPs) = Entry.split(':');
+    std::tie(DSPs, Latency) = DSPs.split(':');
+    const llvm::Optional<utils::OperationKind> Kind =
+        utils::getOperationKind(Name.trim());
+    unsigned DSPCount, LatencyCount;
+    if (!Kind || DSPs.trim().getAsInteger(10, DSPCount) ||
+        Latency.trim().getAsInteger(10, LatencyCount))
+      continue;
+    OperationCosts[*Kind].DSPs = DSPCount;
+    OperationCosts[*Kind].Latency = LatencyCount;
+  }
+}
+
+void ExpensiveLoopOperationCheck::storeOptions(
+    ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "OperationCosts", RawOperationCosts);
+}
+
+void ExpensiveLoopOperationCheck::registerMatchers(MatchFinder *Finder) {
+  const auto InLoop =
+      hasAncestor(stmt(anyOf(forStmt(), whileStmt(), doStmt())));
+  Finder->addMatcher(
+      binaryOperator(anyOf(hasOperatorName("/"), hasOperatorName("%"),
+                           hasOperatorName("/="), hasOperatorName("%="),
+                           hasOperatorName("*"), hasOperatorName("*="),
+                           hasOperatorName("+"), hasOperatorName("-"),
+                           hasOperatorName("+="), hasOperatorName("-=")),
+                     InLoop)
+          .bind("operator"),
+      this);
+  Finder->addMatcher(callExpr(callee(functionDecl()), InLoop).bind("call"),
+                     this);
+}
+
+void ExpensiveLoopOperationCheck::check(
+    const MatchFinder::MatchResult &Result) {
+  ASTContext &Context = *Result.Context;
+
+  if (const auto *Call = Result.Nodes.getNodeAs<CallExpr>("call")) {
+    const FunctionDecl *Callee = Call->getDirectCallee();
+    if (!Callee || !Callee->getIdentifier() || Callee->hasBody())
+      return;
+    const StringRef Name = Callee->getName();
+    // The native_ and half_ variants are the cheap, less precise versions.
+    if (Name.startswith("native_") || Name.startswith("half_"))
+      return;
+    QualType Type = Call->getType();
+    unsigned Lanes = 1;
+    if (const auto *Vector = Type->getAs<VectorType>()) {
+      Type = Vector->getElementType();
+      Lanes = Vector->getNumElements();
+    }
+    utils::OperationKind Kind;
+    if (Name == "pow" || Name == "pown" || Name == "powr" || Name == "rootn")
+      Kind = utils::Pow;
+    else if (Name == "exp" || Name == "exp2" || Name == "exp10" ||
+             Name == "expm1")
+      Kind = utils::Exp;
+    else if (utils::isMathFunction(Name) && isDouble(Type))
+      Kind = utils::DoubleMathFunction;
+    else
+      return;
+    report(Call, Call->getBeginLoc(), ("call to '" + Name + "'").str(), Kind,
+           Lanes, Context);
+    return;
+  }
+
+  const auto *BinOp = Result.Nodes.getNodeAs<BinaryOperator>("operator");
+  BinaryOperatorKind Opcode = BinOp->getOpcode();
+  QualType Type = BinOp->getType();
+  if (const auto *Compound = dyn_cast<CompoundAssignOperator>(BinOp)) {
+    Opcode = BinaryOperator::getOpForCompoundAssignment(Opcode);
+    Type = Compound->getComputationResultType();
+  }
+  unsigned Lanes = 1;
+  if (const auto *Vector = Type->getAs<VectorType>()) {
+    Type = Vector->getElementType();
+    Lanes = Vector->getNumElements();
+  }
+
+  utils::OperationKind Kind;
+  StringRef Description;
+  if (Type->isIntegerType()) {
+    const bool IsLong = Context.getTypeSize(Type) > 32;
+    if (Opcode == BO_Div || Opcode == BO_Rem) {
+      // Divisions and remainders by powers of two are shifts and masks.
+      if (isPowerOfTwo(BinOp->getRHS(), Context))
+        return;
+      Kind = IsLong ? utils::LongDiv : utils::IntDiv;
+      Description = Opcode == BO_Div ? "integer division by a value that is "
+                                       "not a power of two"
+                                     : "integer remainder by a value that is "
+                                       "not a power of two";
+    } else if (Opcode == BO_Mul && IsLong) {
+      if (isPowerOfTwo(BinOp->getLHS(), Context) ||
+          isPowerOfTwo(BinOp->getRHS(), Context))
+        return;
+      Kind = utils::LongMul;
+      Description = "64-bit integer multiplication";
+    } else {
+      return;
+    }
+  } else if (isDouble(Type)) {
+    switch (Opcode) {
+    case BO_Add:
+    case BO_Sub:
+      Kind = utils::DoubleAdd;
+      Description = Opcode == BO_Add ? "double-precision addition"
+                                     : "double-precision subtraction";
+      break;
+    case BO_Mul:
+      Kind = utils::DoubleMul;
+      Description = "double-precision multiplication";
+      break;
+    case BO_Div:
+      Kind = utils::DoubleDiv;
+      Description = "double-precision division";
+      break;
+    default:
+      return;
+    }
+  } else {
+    return;
+  }
+  report(BinOp, BinOp->getOperatorLoc(), Description, Kind, Lanes, Context);
+}
+
+void ExpensiveLoopOperationCheck::report(const Stmt *S, SourceLocation Loc,
+                                         StringRef Description,
+                                         utils::OperationKind Kind,
+                                         unsigned Lanes, ASTContext &Context) {
+  // Every unrolled loop around the operation replicates it. Operations in
+  // fully unrolled loops only are not in a pipeline.
+  uint64_t Copies = 1;
+  bool Pipelined = false;
+  ast_type_traits::DynTypedNode Node =
+      ast_type_traits::DynTypedNode::create(*S);
+  while (true) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() || Parents[0].get<FunctionDecl>())
+      break;
+    Node = Parents[0];
+    const auto *Loop = Node.get<Stmt>();
+    if (!Loop || !utils::isLoop(Loop))
+      continue;
+    if (UnrollLoopsCheck::unrollType(Loop, &Context) !=
+        UnrollLoopsCheck::FullyUnrolled)
+      Pipelined = true;
+    Copies = llvm::SaturatingMultiply(
+        Copies,
+        UnrollLoopsCheck::getUnrollFactor(Loop, &Context).getValueOr(1));
+  }
+  if (!Pipelined)
+    return;
+
+  const utils::OperationCost &Cost = OperationCosts[Kind];
+  const uint64_t DSPs = llvm::SaturatingMultiply(
+      static_cast<uint64_t>(Cost.DSPs) * Lanes, Copies);
+  diag(Loc, "%0 in a pipelined loop is estimated to use %1 DSP block%s1 and "
+            "to add %2 cycle%s2 of latency%select{|, counting the %4 copies "
+            "created by unrolling}3")
+      << Description << static_cast<unsigned>(std::min<uint64_t>(DSPs, ~0U))
+      << Cost.Latency << (Copies > 1)
+      << static_cast<unsigned>(std::min<uint64_t>(Copies, ~0U));
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,49 @@
+//===--- ExpensiveLoopOperationCheck.h - clang-tidy -------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_EXPENSIVELOOPOPERATIONCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_EXPENSIVELOOPOPERATIONCHECK_H
+
+#include "../ClangTidy.h"
+#include "../utils/OperationCosts.h"
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Finds operations in pipelined loops that need a large or deep circuit on an
+/// FPGA: integer divisions and remainders by values that are not powers of
+/// two, 64-bit integer multiplications, double-precision arithmetic and math
+/// functions, and pow and exp. Estimates their DSP blocks and latency from the
+/// cost table shared with fpga-kernel-report, which can be overridden, and
+/// multiplies them by the copies that loop unrolling creates.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-expensive-loop-operation.html
+class ExpensiveLoopOperationCheck : public ClangTidyCheck {
+public:
+  ExpensiveLoopOperationCheck(StringRef Name, ClangTidyContext *Context);
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
+
+private:
+  /// Reports the operation \p S of kind \p Kind, performed on \p Lanes vector
+  /// elements, if it is in a pipelined loop.
+  void report(const Stmt *S, SourceLocation Loc, StringRef Description,
+              utils::OperationKind Kind, unsigned Lanes, ASTContext &Context);
+
+  const std::string RawOperationCosts;
+  utils::OperationCost OperationCosts[utils::NumOperationKinds];
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_EXPENSIVELOOPOPERATIONCHECK_H
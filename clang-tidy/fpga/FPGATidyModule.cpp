@@ -10,11 +10,20 @@
 #include "../ClangTidy.h"
 #include "../ClangTidyModule.h"
 #include "../ClangTidyModuleRegistry.h"
+#include "ChannelDataflowCheck.h"
+#include "ExpensiveLoopOperationCheck.h"
+#include "GlobalMemoryAccessPatternCheck.h"
 #include "IdDependentBackwardBranchCheck.h"
 #include "KernelNameRestrictionCheck.h"
+#include "KernelReportCheck.h"
+#include "LocalMemoryBankConflictCheck.h"
+#include "LoopCarriedDependencyCheck.h"
+#include "PrivateArrayRegistersCheck.h"
 #include "SingleWorkItemBarrierCheck.h"
 #include "StructPackAlignCheck.h"
+#include "TrivialNDRangeKernelCheck.h"
 #include "UnrollLoopsCheck.h"
+#include "WorkGroupSizeCheck.h"
 
 
 using namespace clang::ast_matchers;
@@ -26,16 +35,34 @@ namespace FPGA {
 class FPGAModule : public ClangTidyModule {
 public:
   void addCheckFactories(ClangTidyCheckFactories &CheckFactories) override {
+    CheckFactories.registerCheck<ChannelDataflowCheck>(
+        "fpga-channel-dataflow");
+    CheckFactories.registerCheck<ExpensiveLoopOperationCheck>(
+        "fpga-expensive-loop-operation");
+    CheckFactories.registerCheck<GlobalMemoryAccessPatternCheck>(
+        "fpga-global-memory-access-pattern");
     CheckFactories.registerCheck<IdDependentBackwardBranchCheck>(
         "fpga-id-dependent-backward-branch");
     CheckFactories.registerCheck<KernelNameRestrictionCheck>(
         "fpga-kernel-name-restriction");
+    CheckFactories.registerCheck<KernelReportCheck>(
+        "fpga-kernel-report");
+    CheckFactories.registerCheck<LocalMemoryBankConflictCheck>(
+        "fpga-local-memory-bank-conflict");
+    CheckFactories.registerCheck<LoopCarriedDependencyCheck>(
+        "fpga-loop-carried-dependency");
+    CheckFactories.registerCheck<PrivateArrayRegistersCheck>(
+        "fpga-private-array-registers");
     CheckFactories.registerCheck<SingleWorkItemBarrierCheck>(
         "fpga-single-work-item-barrier");
     CheckFactories.registerCheck<StructPackAlignCheck>(
         "fpga-struct-pack-align");
+    CheckFactories.registerCheck<TrivialNDRangeKernelCheck>(
+        "fpga-trivial-ndrange-kernel");
     CheckFactories.registerCheck<UnrollLoopsCheck>(
         "fpga-unroll-loops");
+    CheckFactories.registerCheck<WorkGroupSizeCheck>(
+        "fpga-work-group-size");
   }
 };
 
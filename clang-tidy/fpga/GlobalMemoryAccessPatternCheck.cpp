@@ -0,0 +1,167 @@
+//===--- GlobalMemoryAccessPatternCheck.cpp - clang-tidy ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "GlobalMemoryAccessPatternCheck.h"
+#include "../utils/IdDependencyAnalyzer.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LoopUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+/// Removes the induction variables of the fully unrolled loops within \p S
+/// from \p Vars: each unrolled copy of the body sees a constant value.
+void removeUnrolledInductionVars(const Stmt *S,
+                                 llvm::SmallPtrSetImpl<const VarDecl *> &Vars,
+                                 ASTContext &Context) {
+  if (!S)
+    return;
+  if (utils::isLoop(S) && utils::isFullyUnrolled(S, Context))
+    if (llvm::Optional<utils::InductionVariable> Induction =
+            utils::getInductionVariable(S, Context))
+      Vars.erase(Induction->Var);
+  for (const Stmt *Child : S->children())
+    removeUnrolledInductionVars(Child, Vars, Context);
+}
+
+enum AccessPattern { Contiguous, Strided, Random };
+
+} // namespace
+
+void GlobalMemoryAccessPatternCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("kernel"),
+      this);
+}
+
+const utils::StrideLoop *GlobalMemoryAccessPatternCheck::getEnclosingLoop(
+    const Expr *Access, const FunctionDecl *Kernel, ASTContext &Context) {
+  const Stmt *Loop = nullptr;
+  ast_type_traits::DynTypedNode Node =
+      ast_type_traits::DynTypedNode::create(*Access);
+  while (true) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() || Parents[0].get<FunctionDecl>() == Kernel)
+      return nullptr;
+    Node = Parents[0];
+    const auto *S = Node.get<Stmt>();
+    if (S && utils::isLoop(S) && !utils::isFullyUnrolled(S, Context)) {
+      Loop = S;
+      break;
+    }
+  }
+
+  std::unique_ptr<utils::StrideLoop> &Cached = Loops[Loop];
+  if (!Cached) {
+    llvm::Optional<utils::InductionVariable> Induction =
+        utils::getInductionVariable(Loop, Context);
+    if (!Induction || Induction->Step == 0)
+      return nullptr;
+    Cached = std::make_unique<utils::StrideLoop>();
+    Cached->InductionVar = Induction->Var;
+    Cached->Step = Induction->Step;
+    utils::collectModifiedVars(Loop, Cached->Varying);
+    Cached->Varying.erase(Induction->Var);
+    removeUnrolledInductionVars(Loop, Cached->Varying, Context);
+  }
+  return Cached.get();
+}
+
+void GlobalMemoryAccessPatternCheck::check(
+    const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+  const utils::IdDependencyAnalyzer::FunctionInfo &IDDepInfo =
+      getTranslationUnitAnalysis<utils::IdDependencyAnalyzer>().analyze(
+          Kernel, Context);
+  const utils::StrideAnalyzer Strides(Kernel, IDDepInfo, Context);
+
+  llvm::SmallVector<utils::MemoryAccess, 16> Accesses;
+  utils::collectMemoryAccesses(Kernel->getBody(), Accesses);
+  unsigned Counts[3] = {0, 0, 0};
+  for (const utils::MemoryAccess &Access : Accesses) {
+    const QualType Element =
+        utils::getElementType(Access.Base->getType(), Context);
+    if (Access.IsMultiDimensional || Element.isNull() ||
+        Element->isIncompleteType() ||
+        Element.getAddressSpace() != LangAS::opencl_global)
+      continue;
+
+    // The access is contiguous if either consecutive work-items or
+    // consecutive iterations of the innermost pipelined loop access
+    // consecutive elements. Otherwise, the loop takes precedence, since its
+    // iterations are what a single work-item issues back to back.
+    utils::AccessStride Stride = Strides.getStride(Access.Index);
+    bool BetweenIterations = false;
+    if (!Stride.isContiguous()) {
+      if (const utils::StrideLoop *Loop =
+              getEnclosingLoop(Access.Access, Kernel, Context)) {
+        utils::AccessStride LoopStride = Strides.getStride(Access.Index, *Loop);
+        if (!LoopStride.isUniform()) {
+          Stride = LoopStride;
+          BetweenIterations = true;
+        }
+      }
+    }
+    if (Stride.isUniform())
+      continue;
+
+    if (Stride.isContiguous()) {
+      ++Counts[Contiguous];
+      continue;
+    }
+    if (Stride.Kind == utils::AccessStride::Irregular) {
+      ++Counts[Random];
+      diag(Access.Access->getBeginLoc(),
+           "%select{load from|store to}0 %1 has an irregular address pattern "
+           "between consecutive %select{work-items|loop iterations}2, which "
+           "prevents burst-coalesced accesses to global memory")
+          << Access.IsWrite << Access.Base << BetweenIterations;
+      continue;
+    }
+    ++Counts[Strided];
+    if (Stride.Kind == utils::AccessStride::Symbolic) {
+      diag(Access.Access->getBeginLoc(),
+           "%select{load from|store to}0 %1 has a stride that is only known at "
+           "run-time between consecutive %select{work-items|loop "
+           "iterations}2, which prevents burst-coalesced accesses to global "
+           "memory")
+          << Access.IsWrite << Access.Base << BetweenIterations;
+      continue;
+    }
+    const int64_t Elements = Stride.Value < 0 ? -Stride.Value : Stride.Value;
+    const int64_t Bytes =
+        Elements * Context.getTypeSizeInChars(Element).getQuantity();
+    diag(Access.Access->getBeginLoc(),
+         "%select{load from|store to}0 %1 has a stride of %2 elements (%3 "
+         "bytes) between consecutive %select{work-items|loop iterations}4, "
+         "which prevents burst-coalesced accesses to global memory")
+        << Access.IsWrite << Access.Base << static_cast<unsigned>(Elements)
+        << static_cast<unsigned>(Bytes) << BetweenIterations;
+  }
+
+  if (Counts[Strided] == 0 && Counts[Random] == 0)
+    return;
+  diag(Kernel->getLocation(),
+       "kernel %0 accesses global memory at %1 contiguous, %2 strided and %3 "
+       "random site%s3; only contiguous accesses are served by "
+       "burst-coalesced load-store units")
+      << Kernel << Counts[Contiguous] << Counts[Strided] << Counts[Random];
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,52 @@
+//===--- GlobalMemoryAccessPatternCheck.h - clang-tidy ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_GLOBALMEMORYACCESSPATTERNCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_GLOBALMEMORYACCESSPATTERNCHECK_H
+
+#include "../ClangTidy.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "llvm/ADT/DenseMap.h"
+#include <memory>
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Classifies the accesses to __global memory of each kernel as contiguous,
+/// strided or random with respect to the work-item ID or the induction
+/// variable of the enclosing loop, and reports the accesses that cannot be
+/// served by burst-coalesced load-store units, together with a per-kernel
+/// summary.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-global-memory-access-pattern.html
+class GlobalMemoryAccessPatternCheck : public ClangTidyCheck {
+public:
+  GlobalMemoryAccessPatternCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+
+private:
+  /// Returns the innermost pipelined loop enclosing \p Access, or nullptr if
+  /// there is none or its induction variable is not known.
+  const utils::StrideLoop *getEnclosingLoop(const Expr *Access,
+                                            const FunctionDecl *Kernel,
+                                            ASTContext &Context);
+
+  /// The induction variables of the loops seen so far; null for loops whose
+  /// induction variable is not known.
+  llvm::DenseMap<const Stmt *, std::unique_ptr<utils::StrideLoop>> Loops;
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_GLOBALMEMORYACCESSPATTERNCHECK_H
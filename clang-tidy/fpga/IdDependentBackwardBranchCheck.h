@@ -11,6 +11,7 @@
 #define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_ID_DEPENDENT_BACKWARD_BRANCH_H
 
 #include "../ClangTidy.h"
+#include "../utils/DivergenceAnalyzer.h"
 
 namespace clang {
 namespace tidy {
@@ -25,47 +26,11 @@ namespace FPGA {
 class IdDependentBackwardBranchCheck : public ClangTidyCheck {
 private:
   enum LoopType { UNK_LOOP = -1, DO_LOOP = 0, WHILE_LOOP = 1, FOR_LOOP = 2 };
-  // Stores information necessary for printing out source of error.
-  struct IDDependencyRecord {
-    IDDependencyRecord(const VarDecl *Declaration, SourceLocation Location,
-                       std::string Message)
-        : VariableDeclaration(Declaration), Location(Location),
-          Message(Message) {}
-    IDDependencyRecord(const FieldDecl *Declaration, SourceLocation Location,
-                       std::string Message)
-        : FieldDeclaration(Declaration), Location(Location), Message(Message) {}
-    IDDependencyRecord() {}
-    const VarDecl *VariableDeclaration;
-    const FieldDecl *FieldDeclaration;
-    SourceLocation Location;
-    std::string Message;
-  };
-  // Stores the locations where ID-dependent variables are created.
-  std::map<const VarDecl *, IDDependencyRecord> IDDepVarsMap;
-  // Stores the locations where ID-dependent fields are created.
-  std::map<const FieldDecl *, IDDependencyRecord> IDDepFieldsMap;
-  /// Returns an IDDependencyRecord if the Expression contains an ID-dependent
-  /// variable, returns a nullptr otherwise.
-  IDDependencyRecord *hasIDDepVar(const Expr *Expression);
-  /// Returns an IDDependencyRecord if the Expression contains an ID-dependent
-  /// field, returns a nullptr otherwise.
-  IDDependencyRecord *hasIDDepField(const Expr *Expression);
-  /// Stores the location an ID-dependent variable is created from a call to
-  /// an ID function in IDDepVarsMap.
-  void saveIDDepVar(const Stmt *Statement, const VarDecl *Variable);
-  /// Stores the location an ID-dependent field is created from a call to an ID
-  /// function in IDDepFieldsMap.
-  void saveIDDepField(const Stmt *Statement, const FieldDecl *Field);
-  /// Stores the location an ID-dependent variable is created from a reference
-  /// to another ID-dependent variable or field in IDDepVarsMap.
-  void saveIDDepVarFromReference(const DeclRefExpr *RefExpr,
-                                 const MemberExpr *MemExpr,
-                                 const VarDecl *PotentialVar);
-  /// Stores the location an ID-dependent field is created from a reference to
-  /// another ID-dependent variable or field in IDDepFieldsMap.
-  void saveIDDepFieldFromReference(const DeclRefExpr *RefExpr,
-                                   const MemberExpr *MemExpr,
-                                   const FieldDecl *PotentialField);
+  utils::DivergenceAnalyzer Divergence;
+  /// Emits a diagnostic at the location where the ID-dependent variable or
+  /// field was created, explaining where its ID-dependency comes from.
+  void diagIDDepOrigin(const ValueDecl *Declaration,
+                       const utils::IdDependencyAnalyzer::Dependency &Dep);
   /// Returns the loop type.
   LoopType getLoopType(const Stmt *Loop);
 
@@ -74,6 +39,7 @@ public:
       : ClangTidyCheck(Name, Context) {}
   void registerMatchers(ast_matchers::MatchFinder *Finder) override;
   void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void onStartOfTranslationUnit() override;
 };
 
 } // namespace FPGA
@@ -10,6 +10,9 @@
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Lex/PPCallbacks.h"
 #include "clang/Lex/Preprocessor.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
 
 using namespace clang::ast_matchers;
 
@@ -18,6 +21,29 @@ namespace tidy {
 namespace FPGA {
 
 namespace {
+
+/// The lowercase file names that the offline compiler uses for its own
+/// intermediate files.
+const llvm::StringSet<> RestrictedNames = {"kernel.cl", "verilog.cl",
+                                           "vhdl.cl"};
+
+/// The length of the longest restricted name.
+const size_t MaxRestrictedNameLength = 10;
+
+/// Returns true if the last component of \p FilePath is a restricted name,
+/// regardless of capitalization.
+bool isRestrictedName(StringRef FilePath) {
+  const StringRef FileName = FilePath.substr(FilePath.find_last_of("/\\") + 1);
+  if (FileName.size() > MaxRestrictedNameLength)
+    return false;
+  llvm::SmallString<16> Lower;
+  for (char C : FileName)
+    Lower.push_back(llvm::toLower(C));
+  return RestrictedNames.count(Lower);
+}
+
+/// Checks every include directive as it is seen, so that nothing is kept
+/// for the whole translation unit.
 class KernelNameRestrictionPPCallbacks : public PPCallbacks {
 public:
   explicit KernelNameRestrictionPPCallbacks(ClangTidyCheck &Check,
@@ -34,12 +60,6 @@ public:
   void EndOfMainFile() override;
 
 private:
-  struct IncludeDirective {
-    SourceLocation Loc;    ///< '#' Location in the include directive
-    std::string Filename;  ///< Filename as a string
-  };
-  std::vector<IncludeDirective> IncludeDirectives;
-
   ClangTidyCheck &Check;
   const SourceManager &SM; 
 };
@@ -56,41 +76,34 @@ void KernelNameRestrictionPPCallbacks::InclusionDirective(
     bool IsAngled, CharSourceRange FilenameRange, const FileEntry *File,
     StringRef SearchPath, StringRef RelativePath, const Module *Imported,
     SrcMgr::CharacteristicKind FileType) {
-  // We recognize the first include as a special main module header and want
-  // to leave it in the top position.
-  IncludeDirective ID = {HashLoc, FileName};
-  IncludeDirectives.push_back(std::move(ID));
-}
-
-void KernelNameRestrictionPPCallbacks::EndOfMainFile() {
-  if (IncludeDirectives.empty())
+  if (!isRestrictedName(FileName))
     return;
 
-  // Check included files for restricted names
-  for (IncludeDirective &ID : IncludeDirectives) {
-    auto FilePath = StringRef(ID.Filename);
-    auto FileName = FilePath.substr(FilePath.find_last_of("/\\") + 1);
-    if (FileName.equals_lower("kernel.cl") || 
-        FileName.equals_lower("verilog.cl") || 
-        FileName.equals_lower("vhdl.cl")) {
-      Check.diag(ID.Loc, 
-                 "The imported kernel source file is named 'kernel.cl',"
-                 "'Verilog.cl', or 'VHDL.cl', which could cause compilation "
-                 "errors.");
-    }
+  // Files included with -include are included from the predefines buffer,
+  // which has no source text to point at; report them on the main file.
+  if (SM.isWrittenInBuiltinFile(HashLoc)) {
+    Check.diag(SM.getLocForStartOfFile(SM.getMainFileID()),
+               "The kernel source file '%0' included on the command line is "
+               "named 'kernel.cl', 'Verilog.cl', or 'VHDL.cl', which could "
+               "cause compilation errors.")
+        << FileName;
+    return;
   }
 
+  Check.diag(HashLoc,
+             "The imported kernel source file is named 'kernel.cl',"
+             "'Verilog.cl', or 'VHDL.cl', which could cause compilation "
+             "errors.");
+}
+
+void KernelNameRestrictionPPCallbacks::EndOfMainFile() {
   // Check main file for restricted names
-  auto Entry = SM.getFileEntryForID(SM.getMainFileID());
-  StringRef FilePath = Entry->getName();
-  auto FileName = FilePath.substr(FilePath.find_last_of("/\\") + 1);
-  if (FileName.equals_lower("kernel.cl") || 
-      FileName.equals_lower("verilog.cl") || 
-      FileName.equals_lower("vhdl.cl")) {
-    Check.diag(SM.getLocForStartOfFile(SM.getMainFileID()),
-               "Naming your OpenCL kernel source file 'kernel.cl', 'Verilog.cl'"
-               ", or 'VHDL.cl' could cause compilation errors.");
-  }
+  const FileEntry *Entry = SM.getFileEntryForID(SM.getMainFileID());
+  if (!Entry || !isRestrictedName(Entry->getName()))
+    return;
+  Check.diag(SM.getLocForStartOfFile(SM.getMainFileID()),
+             "Naming your OpenCL kernel source file 'kernel.cl', 'Verilog.cl'"
+             ", or 'VHDL.cl' could cause compilation errors.");
 }
 
 } // namespace FPGA
@@ -0,0 +1,442 @@
+//===--- KernelReportCheck.cpp - clang-tidy -------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "KernelReportCheck.h"
+#include "UnrollLoopsCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/KernelClassifier.h"
+#include "../utils/LoopUtils.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "../utils/OperationCosts.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <functional>
+#include <limits>
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+/// A burst-coalesced load-store unit to global memory, with its buffers.
+const unsigned GlobalAccessALMs = 1200;
+const unsigned GlobalAccessRAMs = 4;
+/// A port to local memory.
+const unsigned LocalAccessALMs = 40;
+/// An M20K block, which has two ports.
+const unsigned RAMBlockBytes = 2560;
+const unsigned RAMPorts = 2;
+
+llvm::json::Value count(uint64_t N) {
+  return static_cast<int64_t>(
+      std::min<uint64_t>(N, std::numeric_limits<int64_t>::max()));
+}
+
+/// Returns the element type of a vector type, and the number of its lanes.
+std::pair<QualType, unsigned> getLanes(QualType Type) {
+  if (const auto *Vector = Type->getAs<VectorType>())
+    return {Vector->getElementType(), Vector->getNumElements()};
+  return {Type, 1};
+}
+
+llvm::Optional<utils::OperationKind>
+getOperationKind(BinaryOperatorKind Opcode, QualType Type,
+                 const ASTContext &Context) {
+  unsigned Offset;
+  switch (Opcode) {
+  case BO_Add:
+  case BO_Sub:
+  case BO_AddAssign:
+  case BO_SubAssign:
+    Offset = 0;
+    break;
+  case BO_Mul:
+  case BO_MulAssign:
+    Offset = 1;
+    break;
+  case BO_Div:
+  case BO_Rem:
+  case BO_DivAssign:
+  case BO_RemAssign:
+    Offset = 2;
+    break;
+  default:
+    return llvm::None;
+  }
+  if (Type->isRealFloatingType())
+    return static_cast<utils::OperationKind>(
+        (Type->isSpecificBuiltinType(BuiltinType::Double) ? utils::DoubleAdd
+                                                          : utils::FloatAdd) +
+        Offset);
+  if (!Type->isIntegerType())
+    return llvm::None;
+  if (Offset != 0 && Context.getTypeSize(Type) > 32)
+    return Offset == 1 ? utils::LongMul : utils::LongDiv;
+  return static_cast<utils::OperationKind>(utils::IntAdd + Offset);
+}
+
+/// Returns the kind of a call to the math built-in \p Name, without its
+/// ``native_`` or ``half_`` prefix, that returns \p Type.
+utils::OperationKind getMathFunctionKind(StringRef Name, QualType Type,
+                                         bool IsNative) {
+  if (IsNative)
+    return utils::MathFunction;
+  if (Name == "pow" || Name == "pown" || Name == "powr" || Name == "rootn")
+    return utils::Pow;
+  if (Name == "exp" || Name == "exp2" || Name == "exp10" || Name == "expm1")
+    return utils::Exp;
+  return Type->isSpecificBuiltinType(BuiltinType::Double)
+             ? utils::DoubleMathFunction
+             : utils::MathFunction;
+}
+
+/// Returns the number of copies of \p S that unrolling creates within
+/// \p Ancestor, or within the whole function if \p Ancestor is null.
+uint64_t getCopies(const Stmt *S, const Stmt *Ancestor, ASTContext &Context) {
+  uint64_t Copies = 1;
+  auto Node = ast_type_traits::DynTypedNode::create(*S);
+  while (true) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() || Parents[0].get<FunctionDecl>())
+      break;
+    Node = Parents[0];
+    const auto *Parent = Node.get<Stmt>();
+    if (!Parent || !utils::isLoop(Parent))
+      continue;
+    Copies = llvm::SaturatingMultiply(
+        Copies,
+        UnrollLoopsCheck::getUnrollFactor(Parent, &Context).getValueOr(1));
+    if (Parent == Ancestor)
+      break;
+  }
+  return Copies;
+}
+
+/// Returns the number of ports needed by the reads and writes of a local
+/// memory in one clock cycle beyond what replication can provide, as a
+/// number of cycles.
+unsigned getArbitrationCycles(uint64_t Reads, uint64_t Writes) {
+  if (Writes < RAMPorts || Reads + Writes <= RAMPorts)
+    return 1;
+  return static_cast<unsigned>(std::min<uint64_t>(
+      llvm::divideCeil(Reads + Writes, RAMPorts), 1U << 16));
+}
+
+/// Accumulates the operations and loops of a kernel, following the calls to
+/// the functions it calls, which are inlined.
+class KernelEstimator {
+public:
+  explicit KernelEstimator(ASTContext &Context) : Context(Context) {}
+
+  void visit(const Stmt *S, uint64_t Copies, unsigned Depth);
+
+  uint64_t Operations[utils::NumOperationKinds] = {};
+  llvm::json::Array Loops;
+  unsigned LoopNests = 0;
+  unsigned MaxDepth = 0;
+  unsigned II = 1;
+
+private:
+  unsigned getLoopII(const Stmt *Loop);
+
+  ASTContext &Context;
+  llvm::SmallPtrSet<const FunctionDecl *, 4> CallStack;
+};
+
+void KernelEstimator::visit(const Stmt *S, uint64_t Copies, unsigned Depth) {
+  if (!S)
+    return;
+
+  if (utils::isLoop(S)) {
+    const llvm::Optional<uint64_t> Factor =
+        UnrollLoopsCheck::getUnrollFactor(S, &Context);
+    const UnrollLoopsCheck::UnrollType Unroll =
+        UnrollLoopsCheck::unrollType(S, &Context);
+    const llvm::Optional<uint64_t> TripCount = utils::getTripCount(S, Context);
+    if (Depth == 0)
+      ++LoopNests;
+    MaxDepth = std::max(MaxDepth, Depth + 1);
+    llvm::json::Value Unrolled = nullptr;
+    if (Unroll == UnrollLoopsCheck::FullyUnrolled)
+      Unrolled = "full";
+    else if (Unroll == UnrollLoopsCheck::PartiallyUnrolled)
+      Unrolled = count(Factor.getValueOr(1));
+    const unsigned LoopII =
+        Unroll == UnrollLoopsCheck::FullyUnrolled ? 1 : getLoopII(S);
+    II = std::max(II, LoopII);
+    Loops.push_back(llvm::json::Object{
+        {"line", count(Context.getSourceManager().getSpellingLineNumber(
+                     S->getBeginLoc()))},
+        {"depth", count(Depth + 1)},
+        {"unroll", std::move(Unrolled)},
+        {"trip-count",
+         TripCount ? count(*TripCount) : llvm::json::Value(nullptr)},
+        {"ii", count(LoopII)}});
+    Copies = llvm::SaturatingMultiply(Copies, Factor.getValueOr(1));
+    for (const Stmt *Child : S->children())
+      visit(Child, Copies, Depth + 1);
+    return;
+  }
+
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(S)) {
+    QualType Type = BinOp->getType();
+    if (const auto *Compound = dyn_cast<CompoundAssignOperator>(BinOp))
+      Type = Compound->getComputationResultType();
+    const auto Lanes = getLanes(Type);
+    if (auto Kind =
+            getOperationKind(BinOp->getOpcode(), Lanes.first, Context))
+      Operations[*Kind] = llvm::SaturatingAdd(
+          Operations[*Kind], llvm::SaturatingMultiply(Copies, Lanes.second));
+  } else if (const auto *UnOp = dyn_cast<UnaryOperator>(S)) {
+    if (UnOp->isIncrementDecrementOp() && UnOp->getType()->isIntegerType())
+      Operations[utils::IntAdd] =
+          llvm::SaturatingAdd(Operations[utils::IntAdd], Copies);
+  } else if (const auto *Call = dyn_cast<CallExpr>(S)) {
+    if (const FunctionDecl *Callee = Call->getDirectCallee()) {
+      StringRef Name = Callee->getName();
+      const bool IsNative =
+          Name.consume_front("native_") || Name.consume_front("half_");
+      const FunctionDecl *Definition = nullptr;
+      if (utils::isMathFunction(Name)) {
+        const auto Lanes = getLanes(Call->getType());
+        const utils::OperationKind Kind =
+            getMathFunctionKind(Name, Lanes.first, IsNative);
+        Operations[Kind] = llvm::SaturatingAdd(
+            Operations[Kind], llvm::SaturatingMultiply(Copies, Lanes.second));
+      } else if (Callee->hasBody(Definition) &&
+                 CallStack.insert(Definition).second) {
+        visit(Definition->getBody(), Copies, Depth);
+        CallStack.erase(Definition);
+      }
+    }
+  }
+
+  for (const Stmt *Child : S->children())
+    visit(Child, Copies, Depth);
+}
+
+unsigned KernelEstimator::getLoopII(const Stmt *Loop) {
+  unsigned LoopII = 1;
+  const SourceManager &SM = Context.getSourceManager();
+
+  // An accumulation into a floating-point variable declared outside of the
+  // loop waits for the previous iteration's addition.
+  std::function<void(const Stmt *)> FindAccumulations = [&](const Stmt *S) {
+    if (!S)
+      return;
+    const Expr *Target = nullptr;
+    if (const auto *Compound = dyn_cast<CompoundAssignOperator>(S))
+      Target = Compound->getLHS();
+    if (const auto *Ref =
+            dyn_cast_or_null<DeclRefExpr>(Target ? Target->IgnoreParenImpCasts()
+                                                 : nullptr)) {
+      const auto *Var = dyn_cast<VarDecl>(Ref->getDecl());
+      if (Var && Var->getType()->isRealFloatingType() &&
+          !SM.isPointWithin(Var->getLocation(), Loop->getBeginLoc(),
+                            Loop->getEndLoc()))
+        LoopII = std::max(
+            LoopII,
+            utils::getOperationCost(
+                Var->getType()->isSpecificBuiltinType(BuiltinType::Double)
+                    ? utils::DoubleAdd
+                    : utils::FloatAdd)
+                .Latency);
+    }
+    for (const Stmt *Child : S->children())
+      FindAccumulations(Child);
+  };
+  FindAccumulations(Loop);
+
+  // More accesses to a local memory than its ports serve are arbitrated.
+  llvm::SmallVector<utils::MemoryAccess, 16> Accesses;
+  utils::collectMemoryAccesses(Loop, Accesses);
+  llvm::DenseMap<const VarDecl *, std::pair<uint64_t, uint64_t>> Ports;
+  for (const utils::MemoryAccess &Access : Accesses) {
+    if (utils::getElementType(Access.Base->getType(), Context)
+            .getAddressSpace() != LangAS::opencl_local)
+      continue;
+    const uint64_t Copies = getCopies(Access.Access, Loop, Context);
+    auto &Counts = Ports[Access.Base];
+    if (Access.IsRead)
+      Counts.first = llvm::SaturatingAdd(Counts.first, Copies);
+    if (Access.IsWrite)
+      Counts.second = llvm::SaturatingAdd(Counts.second, Copies);
+  }
+  for (const auto &Entry : Ports)
+    LoopII = std::max(LoopII, getArbitrationCycles(Entry.second.first,
+                                                   Entry.second.second));
+  return LoopII;
+}
+
+} // namespace
+
+void KernelReportCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("kernel"),
+      this);
+}
+
+void KernelReportCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+  const SourceManager &SM = *Result.SourceManager;
+  if (MainFile.empty())
+    if (const FileEntry *File = SM.getFileEntryForID(SM.getMainFileID()))
+      MainFile = File->getName();
+
+  KernelEstimator Estimator(Context);
+  Estimator.visit(Kernel->getBody(), 1, 0);
+
+  uint64_t DSPs = 0;
+  uint64_t ALMs = 0;
+  uint64_t RAMs = 0;
+  llvm::json::Object Operations;
+  for (unsigned Kind = 0; Kind != utils::NumOperationKinds; ++Kind) {
+    const uint64_t Count = Estimator.Operations[Kind];
+    const utils::OperationCost &Cost =
+        utils::getOperationCost(static_cast<utils::OperationKind>(Kind));
+    Operations[Cost.Name] = count(Count);
+    DSPs = llvm::SaturatingAdd(
+        DSPs, llvm::SaturatingMultiply<uint64_t>(Count, Cost.DSPs));
+    ALMs = llvm::SaturatingAdd(
+        ALMs, llvm::SaturatingMultiply<uint64_t>(Count, Cost.ALMs));
+  }
+
+  // Every access site gets its own load-store unit or port, and every local
+  // array is replicated until it has enough ports for its reads.
+  uint64_t Accesses[2][2] = {{0, 0}, {0, 0}};
+  llvm::SmallVector<utils::MemoryAccess, 16> Sites;
+  utils::collectMemoryAccesses(Kernel->getBody(), Sites);
+  llvm::MapVector<const VarDecl *, std::pair<uint64_t, uint64_t>> LocalArrays;
+  for (const utils::MemoryAccess &Access : Sites) {
+    const LangAS AddressSpace =
+        utils::getElementType(Access.Base->getType(), Context)
+            .getAddressSpace();
+    const bool IsLocal = AddressSpace == LangAS::opencl_local;
+    if (!IsLocal && AddressSpace != LangAS::opencl_global &&
+        AddressSpace != LangAS::opencl_constant)
+      continue;
+    const uint64_t Copies = getCopies(Access.Access, nullptr, Context);
+    if (Access.IsRead)
+      Accesses[IsLocal][0] = llvm::SaturatingAdd(Accesses[IsLocal][0], Copies);
+    if (Access.IsWrite)
+      Accesses[IsLocal][1] = llvm::SaturatingAdd(Accesses[IsLocal][1], Copies);
+    if (IsLocal && Access.Base->getType()->isConstantArrayType()) {
+      auto &Counts = LocalArrays[Access.Base];
+      if (Access.IsRead)
+        Counts.first = llvm::SaturatingAdd(Counts.first, Copies);
+      if (Access.IsWrite)
+        Counts.second = llvm::SaturatingAdd(Counts.second, Copies);
+    }
+  }
+  const uint64_t GlobalSites =
+      llvm::SaturatingAdd(Accesses[false][0], Accesses[false][1]);
+  const uint64_t LocalSites =
+      llvm::SaturatingAdd(Accesses[true][0], Accesses[true][1]);
+  ALMs = llvm::SaturatingAdd(
+      ALMs, llvm::SaturatingMultiply<uint64_t>(GlobalSites, GlobalAccessALMs));
+  ALMs = llvm::SaturatingAdd(
+      ALMs, llvm::SaturatingMultiply<uint64_t>(LocalSites, LocalAccessALMs));
+  RAMs = llvm::SaturatingAdd(
+      RAMs, llvm::SaturatingMultiply<uint64_t>(GlobalSites, GlobalAccessRAMs));
+  for (const auto &Entry : LocalArrays) {
+    const uint64_t Reads = Entry.second.first;
+    const uint64_t Writes = Entry.second.second;
+    const uint64_t Replicas =
+        Writes >= RAMPorts ? 1
+                           : llvm::divideCeil(std::max<uint64_t>(Reads, 1),
+                                              RAMPorts - Writes);
+    const uint64_t Blocks = llvm::divideCeil(
+        Context.getTypeSizeInChars(Entry.first->getType()).getQuantity(),
+        RAMBlockBytes);
+    RAMs = llvm::SaturatingAdd(RAMs,
+                               llvm::SaturatingMultiply(Blocks, Replicas));
+  }
+
+  diag(Kernel->getLocation(),
+       "kernel %0 is estimated to use %1 DSP block%s1, %2 ALM%s2 and %3 RAM "
+       "block%s3, with an initiation interval of %4")
+      << Kernel << static_cast<unsigned>(std::min<uint64_t>(DSPs, ~0U))
+      << static_cast<unsigned>(std::min<uint64_t>(ALMs, ~0U))
+      << static_cast<unsigned>(std::min<uint64_t>(RAMs, ~0U)) << Estimator.II;
+
+  if (ReportDirectory.empty())
+    return;
+  const PresumedLoc Loc = SM.getPresumedLoc(Kernel->getLocation());
+  const bool IsNDRange = getTranslationUnitAnalysis<utils::KernelClassifier>()
+                             .classify(Kernel, Context)
+                             .Model == utils::KernelClassifier::NDRange;
+  Kernels.push_back(llvm::json::Object{
+      {"name", Kernel->getName()},
+      {"execution-model", IsNDRange ? "ndrange" : "single-work-item"},
+      {"file", Loc.isValid() ? Loc.getFilename() : ""},
+      {"line", count(Loc.isValid() ? Loc.getLine() : 0)},
+      {"operations", std::move(Operations)},
+      {"memory",
+       llvm::json::Object{{"global-loads", count(Accesses[false][0])},
+                    {"global-stores", count(Accesses[false][1])},
+                    {"local-loads", count(Accesses[true][0])},
+                    {"local-stores", count(Accesses[true][1])}}},
+      {"loop-nests", count(Estimator.LoopNests)},
+      {"max-loop-depth", count(Estimator.MaxDepth)},
+      {"loops", std::move(Estimator.Loops)},
+      {"estimate", llvm::json::Object{{"dsp", count(DSPs)},
+                                {"alm", count(ALMs)},
+                                {"ram", count(RAMs)},
+                                {"ii", count(Estimator.II)}}}});
+}
+
+void KernelReportCheck::onEndOfTranslationUnit() {
+  if (!ReportDirectory.empty() && !Kernels.empty()) {
+    // Main files with the same name in different directories must not
+    // overwrite each other's report, so the name includes a hash of the path.
+    llvm::MD5 Hash;
+    Hash.update(MainFile);
+    llvm::MD5::MD5Result Digest;
+    Hash.final(Digest);
+    const llvm::SmallString<32> Hex = Digest.digest();
+    llvm::SmallString<128> Path(ReportDirectory);
+    llvm::sys::path::append(Path, llvm::sys::path::filename(MainFile) + "." +
+                                      Hex.substr(0, 16) + ".kernels.json");
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(Path, EC, llvm::sys::fs::OF_Text);
+    if (EC) {
+      diag(SourceLocation(), "cannot write the kernel report %0: %1")
+          << Path.str() << EC.message();
+    } else {
+      OS << llvm::formatv(
+                "{0:2}",
+                llvm::json::Value(llvm::json::Object{{"file", MainFile},
+                                         {"kernels", std::move(Kernels)}}))
+         << "\n";
+    }
+  }
+  Kernels = llvm::json::Array();
+  MainFile.clear();
+}
+
+void KernelReportCheck::storeOptions(ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "ReportDirectory", ReportDirectory);
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
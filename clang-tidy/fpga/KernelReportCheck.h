@@ -0,0 +1,48 @@
+//===--- KernelReportCheck.h - clang-tidy -----------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_KERNELREPORTCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_KERNELREPORTCHECK_H
+
+#include "../ClangTidy.h"
+#include "llvm/Support/JSON.h"
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Estimates the DSP, ALM and RAM usage and the initiation interval of each
+/// kernel from its arithmetic operations, memory accesses and loops, after
+/// unrolling. Reports the estimate for each kernel, and writes the details as
+/// JSON to the directory given by the ReportDirectory option.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-kernel-report.html
+class KernelReportCheck : public ClangTidyCheck {
+  const std::string ReportDirectory;
+
+public:
+  KernelReportCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context),
+        ReportDirectory(Options.get("ReportDirectory", "")) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void onEndOfTranslationUnit() override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
+
+private:
+  /// The path of the main file, and the report of each of its kernels.
+  std::string MainFile;
+  llvm::json::Array Kernels;
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_KERNELREPORTCHECK_H
@@ -0,0 +1,475 @@
+//===--- LocalMemoryBankConflictCheck.cpp - clang-tidy --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LocalMemoryBankConflictCheck.h"
+#include "UnrollLoopsCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LexerUtils.h"
+#include "../utils/LoopUtils.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/CheckedArithmetic.h"
+#include "llvm/Support/MathExtras.h"
+#include <limits>
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+/// The unrolled copies of a single access site are enumerated to assign them
+/// to banks only up to this number.
+const uint64_t MaxEnumeratedCopies = 1024;
+
+/// An index of the form Constant + the sum of Coefficient * Var.
+struct LinearIndex {
+  int64_t Constant = 0;
+  llvm::SmallDenseMap<const VarDecl *, int64_t, 4> Coefficients;
+};
+
+/// Adds Factor * From to Into. Returns false on overflow.
+bool addScaled(LinearIndex &Into, const LinearIndex &From, int64_t Factor) {
+  llvm::Optional<int64_t> Term = llvm::checkedMul(From.Constant, Factor);
+  llvm::Optional<int64_t> Sum =
+      Term ? llvm::checkedAdd(Into.Constant, *Term) : llvm::None;
+  if (!Sum)
+    return false;
+  Into.Constant = *Sum;
+  for (const auto &Entry : From.Coefficients) {
+    Term = llvm::checkedMul(Entry.second, Factor);
+    Sum = Term ? llvm::checkedAdd(Into.Coefficients[Entry.first], *Term)
+               : llvm::None;
+    if (!Sum)
+      return false;
+    Into.Coefficients[Entry.first] = *Sum;
+  }
+  return true;
+}
+
+llvm::Optional<LinearIndex> getLinearIndex(const Expr *E,
+                                           const ASTContext &Context) {
+  LinearIndex Result;
+  if (!E)
+    return Result;
+  E = E->IgnoreParenCasts();
+  if (llvm::Optional<int64_t> Value = utils::evaluateInteger(E, Context)) {
+    Result.Constant = *Value;
+    return Result;
+  }
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E)) {
+    if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl())) {
+      Result.Coefficients[Var] = 1;
+      return Result;
+    }
+    return llvm::None;
+  }
+  if (const auto *Unary = dyn_cast<UnaryOperator>(E)) {
+    llvm::Optional<LinearIndex> Sub =
+        getLinearIndex(Unary->getSubExpr(), Context);
+    if (!Sub)
+      return llvm::None;
+    if (Unary->getOpcode() == UO_Plus)
+      return Sub;
+    if (Unary->getOpcode() == UO_Minus && addScaled(Result, *Sub, -1))
+      return Result;
+    return llvm::None;
+  }
+  const auto *BinOp = dyn_cast<BinaryOperator>(E);
+  if (!BinOp)
+    return llvm::None;
+  llvm::Optional<LinearIndex> LHS = getLinearIndex(BinOp->getLHS(), Context);
+  llvm::Optional<LinearIndex> RHS = getLinearIndex(BinOp->getRHS(), Context);
+  if (!LHS || !RHS)
+    return llvm::None;
+  switch (BinOp->getOpcode()) {
+  case BO_Add:
+    if (addScaled(*LHS, *RHS, 1))
+      return LHS;
+    return llvm::None;
+  case BO_Sub:
+    if (addScaled(*LHS, *RHS, -1))
+      return LHS;
+    return llvm::None;
+  case BO_Mul:
+    if (LHS->Coefficients.empty() && addScaled(Result, *RHS, LHS->Constant))
+      return Result;
+    if (RHS->Coefficients.empty() && addScaled(Result, *LHS, RHS->Constant))
+      return Result;
+    return llvm::None;
+  case BO_Shl:
+    if (RHS->Coefficients.empty() && RHS->Constant >= 0 &&
+        RHS->Constant < 32 &&
+        addScaled(Result, *LHS, int64_t(1) << RHS->Constant))
+      return Result;
+    return llvm::None;
+  default:
+    return llvm::None;
+  }
+}
+
+/// Returns the index of \p Access into the array flattened to one dimension.
+llvm::Optional<LinearIndex> getFlatIndex(const utils::MemoryAccess &Access,
+                                         const ASTContext &Context) {
+  llvm::Optional<LinearIndex> Result = getLinearIndex(Access.Index, Context);
+  const auto *Subscript = dyn_cast<ArraySubscriptExpr>(Access.Access);
+  if (!Result || !Subscript)
+    return Result;
+  int64_t Multiplier = 1;
+  const Expr *Base = Subscript->getBase()->IgnoreParenImpCasts();
+  while (const auto *Outer = dyn_cast<ArraySubscriptExpr>(Base)) {
+    // The type of A[i] in A[i][j] is the row that j indexes.
+    const ConstantArrayType *Row = Context.getAsConstantArrayType(
+        Outer->getType());
+    if (!Row)
+      return llvm::None;
+    llvm::Optional<int64_t> NewMultiplier = llvm::checkedMul<int64_t>(
+        Multiplier, static_cast<int64_t>(Row->getSize().getZExtValue()));
+    llvm::Optional<LinearIndex> OuterIndex =
+        getLinearIndex(Outer->getIdx(), Context);
+    if (!NewMultiplier || !OuterIndex ||
+        !addScaled(*Result, *OuterIndex, *NewMultiplier))
+      return llvm::None;
+    Multiplier = *NewMultiplier;
+    Base = Outer->getBase()->IgnoreParenImpCasts();
+  }
+  return Result;
+}
+
+/// A loop whose body is replicated within one pipelined iteration: a fully
+/// unrolled loop, or the pipelined loop itself if it is partially unrolled.
+struct UnrolledLoop {
+  const VarDecl *Var = nullptr;
+  int64_t Init = 0;
+  int64_t Step = 0;
+  uint64_t Copies = 1;
+  /// True for the pipelined loop, whose induction variable keeps varying
+  /// between iterations.
+  bool Pipelined = false;
+  /// False if the initial value of the induction variable is not a constant.
+  bool KnownInit = true;
+};
+
+/// The accesses to one __local array in one pipelined loop (or in the kernel
+/// body, outside of any loop).
+struct PortUsage {
+  const VarDecl *Array = nullptr;
+  const Stmt *Loop = nullptr;
+  const Expr *FirstAccess = nullptr;
+  unsigned Reads = 0;
+  unsigned Writes = 0;
+  /// False if some access cannot be assigned to a bank at compile time.
+  bool Bankable = true;
+  /// The GCD of the coefficients of the variables the indices depend on; a
+  /// number of banks that divides it maps every access to a fixed bank.
+  uint64_t Divisor = 0;
+  /// The constant part of the index of each unrolled access, and whether it
+  /// reads and writes.
+  struct Site {
+    int64_t Offset;
+    bool IsRead;
+    bool IsWrite;
+  };
+  llvm::SmallVector<Site, 16> Sites;
+};
+
+/// How the compiler provides enough ports for a memory system.
+struct PortAllocation {
+  /// The number of copies of the memory.
+  unsigned Replicas = 1;
+  /// True if the accesses have to share ports.
+  bool Arbitrated = false;
+};
+
+PortAllocation allocatePorts(unsigned Reads, unsigned Writes, unsigned Ports) {
+  PortAllocation Result;
+  if (Reads + Writes <= Ports)
+    return Result;
+  if (Writes >= Ports) {
+    Result.Arbitrated = true;
+    return Result;
+  }
+  // Every replica is written by all the writes, and serves a share of the
+  // reads with its remaining ports.
+  const unsigned ReadPorts = Ports - Writes;
+  Result.Replicas = (Reads + ReadPorts - 1) / ReadPorts;
+  return Result;
+}
+
+/// Returns true if splitting the memory into \p NumBanks banks serves every
+/// access without replication or arbitration.
+bool fitsInBanks(const PortUsage &Usage, unsigned NumBanks, unsigned Ports) {
+  if (!Usage.Bankable || Usage.Divisor % NumBanks != 0)
+    return false;
+  llvm::SmallVector<unsigned, 16> BankPorts(NumBanks, 0);
+  for (const PortUsage::Site &Site : Usage.Sites) {
+    int64_t Bank = Site.Offset % static_cast<int64_t>(NumBanks);
+    if (Bank < 0)
+      Bank += NumBanks;
+    BankPorts[Bank] += Site.IsRead + Site.IsWrite;
+    if (BankPorts[Bank] > Ports)
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+void LocalMemoryBankConflictCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("kernel"),
+      this);
+}
+
+void LocalMemoryBankConflictCheck::check(
+    const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+  const SourceManager &SM = *Result.SourceManager;
+
+  llvm::SmallVector<utils::MemoryAccess, 16> Accesses;
+  utils::collectMemoryAccesses(Kernel->getBody(), Accesses);
+  std::vector<PortUsage> Usages;
+  llvm::DenseMap<std::pair<const VarDecl *, const Stmt *>, unsigned> Indices;
+
+  for (const utils::MemoryAccess &Access : Accesses) {
+    if (!Access.Base->getType()->isConstantArrayType() ||
+        Context.getBaseElementType(Access.Base->getType()).getAddressSpace() !=
+            LangAS::opencl_local)
+      continue;
+
+    // Find the pipelined loop around the access, and the loops between them
+    // whose bodies are replicated.
+    llvm::SmallVector<UnrolledLoop, 4> Unrolled;
+    const Stmt *Loop = nullptr;
+    bool KnownCopies = true;
+    ast_type_traits::DynTypedNode Node =
+        ast_type_traits::DynTypedNode::create(*Access.Access);
+    while (!Loop) {
+      const auto Parents = Context.getParents(Node);
+      if (Parents.empty() || Parents[0].get<FunctionDecl>())
+        break;
+      Node = Parents[0];
+      const auto *S = Node.get<Stmt>();
+      if (!S || !utils::isLoop(S))
+        continue;
+      const llvm::Optional<uint64_t> Factor =
+          UnrollLoopsCheck::getUnrollFactor(S, &Context);
+      if (!Factor) {
+        KnownCopies = false;
+        break;
+      }
+      UnrolledLoop Copies;
+      Copies.Copies = *Factor;
+      if (const auto Induction = utils::getInductionLoop(S, Context)) {
+        Copies.Var = Induction->Var;
+        Copies.Init = Induction->Init;
+        Copies.Step = Induction->Step;
+      } else if (const auto Induction =
+                     utils::getInductionVariable(S, Context)) {
+        // Only the pipelined loop can have an unknown initial value; its
+        // copies are then assigned to banks relative to each other.
+        Copies.Var = Induction->Var;
+        Copies.Step = Induction->Step;
+        Copies.KnownInit = false;
+      }
+      if (UnrollLoopsCheck::unrollType(S, &Context) !=
+          UnrollLoopsCheck::FullyUnrolled) {
+        Copies.Pipelined = true;
+        Loop = S;
+      }
+      Unrolled.push_back(Copies);
+    }
+    if (!KnownCopies)
+      continue;
+
+    auto Inserted =
+        Indices.insert({{Access.Base, Loop}, unsigned(Usages.size())});
+    if (Inserted.second) {
+      Usages.emplace_back();
+      Usages.back().Array = Access.Base;
+      Usages.back().Loop = Loop;
+      Usages.back().FirstAccess = Access.Access;
+    }
+    PortUsage &Usage = Usages[Inserted.first->second];
+
+    uint64_t Copies = 1;
+    for (const UnrolledLoop &Copy : Unrolled)
+      Copies = llvm::SaturatingMultiply(Copies, Copy.Copies);
+    const unsigned Sites = static_cast<unsigned>(
+        std::min<uint64_t>(Copies, std::numeric_limits<unsigned>::max()));
+    if (Access.IsRead)
+      Usage.Reads = llvm::SaturatingAdd(Usage.Reads, Sites);
+    if (Access.IsWrite)
+      Usage.Writes = llvm::SaturatingAdd(Usage.Writes, Sites);
+
+    llvm::Optional<LinearIndex> Index = getFlatIndex(Access, Context);
+    if (!Usage.Bankable || !Index || Copies > MaxEnumeratedCopies) {
+      Usage.Bankable = false;
+      continue;
+    }
+
+    // Every copy adds a constant to the index for each unrolled induction
+    // variable. The remaining variables, and the pipelined induction variable
+    // between iterations, only move the index by multiples of their
+    // coefficients.
+    LinearIndex Base = *Index;
+    llvm::SmallVector<int64_t, 4> Moves;
+    for (const UnrolledLoop &Copy : Unrolled) {
+      if (!Copy.Var) {
+        if (Copy.Copies > 1)
+          Usage.Bankable = false;
+        continue;
+      }
+      auto Found = Base.Coefficients.find(Copy.Var);
+      if (Found == Base.Coefficients.end())
+        continue;
+      const int64_t Coefficient = Found->second;
+      Base.Coefficients.erase(Found);
+      llvm::Optional<int64_t> Offset = llvm::checkedMul(Coefficient, Copy.Init);
+      llvm::Optional<int64_t> Constant =
+          Offset ? llvm::checkedAdd(Base.Constant, *Offset) : llvm::None;
+      llvm::Optional<int64_t> Step = llvm::checkedMul<int64_t>(
+          Copy.Step, static_cast<int64_t>(Copy.Copies));
+      llvm::Optional<int64_t> Stride =
+          Step ? llvm::checkedMul(Coefficient, *Step) : llvm::None;
+      if (!Constant || !Stride) {
+        Usage.Bankable = false;
+        break;
+      }
+      Base.Constant = *Constant;
+      if (Copy.Pipelined)
+        Moves.push_back(*Stride);
+      if (!Copy.KnownInit)
+        Moves.push_back(Coefficient);
+    }
+    if (!Usage.Bankable)
+      continue;
+    for (const auto &Entry : Base.Coefficients)
+      Moves.push_back(Entry.second);
+    for (int64_t Move : Moves)
+      Usage.Divisor = llvm::GreatestCommonDivisor64(
+          Usage.Divisor, static_cast<uint64_t>(Move < 0 ? -Move : Move));
+
+    // Enumerate the copies, with the last loop varying fastest. An offset
+    // that overflows cannot be placed in a bank, so the access is skipped and
+    // the array is treated as not bankable.
+    llvm::SmallVector<uint64_t, 4> Counters(Unrolled.size(), 0);
+    llvm::SmallVector<PortUsage::Site, 16> Sites;
+    bool Overflow = false;
+    for (uint64_t I = 0; I != Copies && !Overflow; ++I) {
+      int64_t Offset = Base.Constant;
+      for (unsigned L = 0; L != Unrolled.size() && !Overflow; ++L) {
+        const UnrolledLoop &Copy = Unrolled[L];
+        if (!Copy.Var)
+          continue;
+        auto Found = Index->Coefficients.find(Copy.Var);
+        if (Found == Index->Coefficients.end())
+          continue;
+        int64_t Term;
+        Overflow = llvm::MulOverflow(Found->second, Copy.Step, Term) ||
+                   llvm::MulOverflow(Term, static_cast<int64_t>(Counters[L]),
+                                     Term) ||
+                   llvm::AddOverflow(Offset, Term, Offset);
+      }
+      Sites.push_back({Offset, Access.IsRead, Access.IsWrite});
+      for (unsigned L = Unrolled.size(); L-- != 0;) {
+        if (++Counters[L] < Unrolled[L].Copies)
+          break;
+        Counters[L] = 0;
+      }
+    }
+    if (Overflow) {
+      Usage.Bankable = false;
+      continue;
+    }
+    Usage.Sites.append(Sites.begin(), Sites.end());
+  }
+
+  llvm::SmallPtrSet<const VarDecl *, 4> FixedArrays;
+  for (const PortUsage &Usage : Usages) {
+    // clang does not know the numbanks attribute, so look for it in the
+    // source text of the declaration.
+    const llvm::Optional<uint64_t> NumBanks =
+        utils::lexer::getAttributeArgument(Usage.Array, "numbanks", SM,
+                                           Context.getLangOpts());
+    if (NumBanks && *NumBanks != 0 &&
+        *NumBanks <= std::numeric_limits<uint16_t>::max() &&
+        fitsInBanks(Usage, static_cast<unsigned>(*NumBanks), PortsPerBank))
+      continue;
+    const PortAllocation Allocation =
+        allocatePorts(Usage.Reads, Usage.Writes, PortsPerBank);
+    if (Allocation.Replicas == 1 && !Allocation.Arbitrated)
+      continue;
+
+    if (Allocation.Arbitrated) {
+      diag(Usage.FirstAccess->getBeginLoc(),
+           "local memory %0 is accessed by %1 read%s1 and %2 write%s2 per "
+           "%select{work-item|loop iteration}3, but a memory bank only has %4 "
+           "ports; the compiler will arbitrate between the accesses, which "
+           "stalls the pipeline")
+          << Usage.Array << Usage.Reads << Usage.Writes
+          << (Usage.Loop != nullptr) << PortsPerBank;
+    } else {
+      diag(Usage.FirstAccess->getBeginLoc(),
+           "local memory %0 is accessed by %1 read%s1 and %2 write%s2 per "
+           "%select{work-item|loop iteration}3, but a memory bank only has %4 "
+           "ports; the compiler will replicate it %5 times")
+          << Usage.Array << Usage.Reads << Usage.Writes
+          << (Usage.Loop != nullptr) << PortsPerBank << Allocation.Replicas;
+    }
+
+    unsigned Banks = 0;
+    for (unsigned Candidate = 2; Candidate <= MaxBanks; Candidate *= 2) {
+      if (fitsInBanks(Usage, Candidate, PortsPerBank)) {
+        Banks = Candidate;
+        break;
+      }
+    }
+    if (Banks == 0 || NumBanks) {
+      if (Allocation.Arbitrated)
+        diag(Usage.Array->getLocation(),
+             "consider partitioning %0 into separate arrays, or reducing the "
+             "unroll factor",
+             DiagnosticIDs::Note)
+            << Usage.Array;
+      continue;
+    }
+    const CharUnits Width = Context.getTypeSizeInChars(
+        Context.getBaseElementType(Usage.Array->getType()));
+    auto Diag = diag(Usage.Array->getLocation(),
+                     "declare %0 with %1 banks to serve these accesses from "
+                     "separate banks",
+                     DiagnosticIDs::Note)
+                << Usage.Array << Banks;
+    const SourceLocation End = Usage.Array->getEndLoc();
+    if (!End.isMacroID() && FixedArrays.insert(Usage.Array).second)
+      Diag << FixItHint::CreateInsertion(
+          Lexer::getLocForEndOfToken(End, 0, SM, Context.getLangOpts()),
+          (" __attribute__((numbanks(" + llvm::Twine(Banks) +
+           "), bankwidth(" + llvm::Twine(Width.getQuantity()) + ")))")
+              .str());
+  }
+}
+
+void LocalMemoryBankConflictCheck::storeOptions(
+    ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "PortsPerBank", PortsPerBank);
+  Options.store(Opts, "MaxBanks", MaxBanks);
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
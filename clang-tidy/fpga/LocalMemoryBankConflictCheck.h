@@ -0,0 +1,44 @@
+//===--- LocalMemoryBankConflictCheck.h - clang-tidy ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_LOCALMEMORYBANKCONFLICTCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_LOCALMEMORYBANKCONFLICTCHECK_H
+
+#include "../ClangTidy.h"
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Counts the read and write sites of each __local array per loop iteration,
+/// after unrolling, and predicts when the compiler has to arbitrate between
+/// them or replicate the memory to provide enough ports. Suggests the
+/// numbanks and bankwidth attributes when the accesses can be served by
+/// separate banks.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-local-memory-bank-conflict.html
+class LocalMemoryBankConflictCheck : public ClangTidyCheck {
+  const unsigned PortsPerBank;
+  const unsigned MaxBanks;
+
+public:
+  LocalMemoryBankConflictCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context),
+        PortsPerBank(Options.get("PortsPerBank", 2U)),
+        MaxBanks(Options.get("MaxBanks", 16U)) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_LOCALMEMORYBANKCONFLICTCHECK_H
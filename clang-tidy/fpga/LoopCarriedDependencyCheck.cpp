@@ -0,0 +1,551 @@
+//===--- LoopCarriedDependencyCheck.cpp - clang-tidy ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LoopCarriedDependencyCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LoopUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Basic/CharInfo.h"
+#include "clang/Lex/Lexer.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "clang/Lex/Preprocessor.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+class LoopCarriedDependencyPPCallbacks : public PPCallbacks {
+public:
+  LoopCarriedDependencyPPCallbacks(LoopCarriedDependencyCheck &Check,
+                                   const SourceManager &SM)
+      : Check(Check), SM(SM) {}
+
+  void PragmaDirective(SourceLocation Loc,
+                       PragmaIntroducerKind Introducer) override {
+    if (Introducer != PIK_HashPragma || !Loc.isFileID())
+      return;
+    // #pragma ivdep is unknown to clang, so it is read from the source text.
+    const std::pair<FileID, unsigned> Decomposed = SM.getDecomposedLoc(Loc);
+    bool Invalid = false;
+    StringRef Text = SM.getBufferData(Decomposed.first, &Invalid);
+    if (Invalid)
+      return;
+    Text = Text.substr(Decomposed.second);
+    Text = Text.substr(0, Text.find_first_of("\r\n")).drop_front().ltrim();
+    if (!Text.consume_front("pragma"))
+      return;
+    Text = Text.ltrim();
+    const StringRef Name =
+        Text.take_while([](char C) { return isIdentifierBody(C); });
+    Check.addLoopPragma(Loc, Name == "ivdep", SM);
+  }
+
+private:
+  LoopCarriedDependencyCheck &Check;
+  const SourceManager &SM;
+};
+
+/// An index of the form Coefficient * Var + Offset.
+struct AffineIndex {
+  int64_t Coefficient;
+  int64_t Offset;
+};
+
+llvm::Optional<AffineIndex> getAffineIndex(const Expr *Index,
+                                           const VarDecl *Var,
+                                           const ASTContext &Context) {
+  Index = Index->IgnoreParenImpCasts();
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(Index))
+    if (Ref->getDecl() == Var)
+      return AffineIndex{1, 0};
+  if (llvm::Optional<int64_t> Value = utils::evaluateInteger(Index, Context))
+    return AffineIndex{0, *Value};
+
+  const auto *BinOp = dyn_cast<BinaryOperator>(Index);
+  if (!BinOp)
+    return llvm::None;
+  llvm::Optional<AffineIndex> LHS =
+      getAffineIndex(BinOp->getLHS(), Var, Context);
+  llvm::Optional<AffineIndex> RHS =
+      getAffineIndex(BinOp->getRHS(), Var, Context);
+  if (!LHS || !RHS)
+    return llvm::None;
+  switch (BinOp->getOpcode()) {
+  case BO_Add:
+    return AffineIndex{LHS->Coefficient + RHS->Coefficient,
+                       LHS->Offset + RHS->Offset};
+  case BO_Sub:
+    return AffineIndex{LHS->Coefficient - RHS->Coefficient,
+                       LHS->Offset - RHS->Offset};
+  case BO_Mul:
+    if (LHS->Coefficient == 0)
+      return AffineIndex{LHS->Offset * RHS->Coefficient,
+                         LHS->Offset * RHS->Offset};
+    if (RHS->Coefficient == 0)
+      return AffineIndex{RHS->Offset * LHS->Coefficient,
+                         RHS->Offset * LHS->Offset};
+    return llvm::None;
+  default:
+    return llvm::None;
+  }
+}
+
+const VarDecl *getArrayBase(const ArraySubscriptExpr *Subscript) {
+  if (const auto *Ref =
+          dyn_cast<DeclRefExpr>(Subscript->getBase()->IgnoreParenImpCasts()))
+    return dyn_cast<VarDecl>(Ref->getDecl());
+  return nullptr;
+}
+
+bool isFloatingType(QualType Type) {
+  if (const auto *Vector = Type->getAs<VectorType>())
+    Type = Vector->getElementType();
+  return Type->isRealFloatingType();
+}
+
+/// Returns the number of floating-point operations between a read of \p Var
+/// in \p E and the value of \p E, or None if \p E does not read \p Var.
+llvm::Optional<unsigned> getRecurrenceDepth(const Expr *E, const VarDecl *Var) {
+  E = E->IgnoreParenImpCasts();
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E))
+    return Ref->getDecl() == Var ? llvm::Optional<unsigned>(0) : llvm::None;
+  llvm::Optional<unsigned> Depth;
+  for (const Stmt *Child : E->children()) {
+    const auto *ChildExpr = dyn_cast_or_null<Expr>(Child);
+    if (!ChildExpr)
+      continue;
+    llvm::Optional<unsigned> ChildDepth = getRecurrenceDepth(ChildExpr, Var);
+    if (ChildDepth && (!Depth || *ChildDepth > *Depth))
+      Depth = ChildDepth;
+  }
+  const auto *BinOp = dyn_cast<BinaryOperator>(E);
+  if (Depth && BinOp &&
+      (BinOp->isMultiplicativeOp() || BinOp->isAdditiveOp()) &&
+      isFloatingType(BinOp->getType()))
+    return *Depth + 1;
+  return Depth;
+}
+
+/// Records \p E in \p Reads if it is an array element.
+void addRead(const Expr *E,
+             llvm::SmallVectorImpl<const ArraySubscriptExpr *> &Reads) {
+  if (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(E->IgnoreParens()))
+    Reads.push_back(Subscript);
+}
+
+void collectAccesses(const Stmt *S, bool IsWrite,
+                     llvm::SmallVectorImpl<const ArraySubscriptExpr *> &Reads,
+                     llvm::SmallVectorImpl<const ArraySubscriptExpr *> &Writes) {
+  if (!S)
+    return;
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(S)) {
+    if (BinOp->isAssignmentOp()) {
+      // A compound assignment also reads its left-hand side, which another
+      // iteration may have written, as in a histogram.
+      if (BinOp->isCompoundAssignmentOp())
+        addRead(BinOp->getLHS(), Reads);
+      collectAccesses(BinOp->getLHS()->IgnoreParens(), true, Reads, Writes);
+      collectAccesses(BinOp->getRHS(), false, Reads, Writes);
+      return;
+    }
+  } else if (const auto *Unary = dyn_cast<UnaryOperator>(S)) {
+    if (Unary->isIncrementDecrementOp()) {
+      addRead(Unary->getSubExpr(), Reads);
+      collectAccesses(Unary->getSubExpr()->IgnoreParens(), true, Reads, Writes);
+      return;
+    }
+  } else if (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(S)) {
+    (IsWrite ? Writes : Reads).push_back(Subscript);
+  }
+  for (const Stmt *Child : S->children())
+    collectAccesses(Child, false, Reads, Writes);
+}
+
+/// Returns the value that \p Assignment adds to \p Var if it has the form
+/// ``Var += E``, ``Var = Var + E`` or ``Var = E + Var``, where ``E`` does not
+/// read ``Var``, such as the product of a dot product.
+const Expr *getAddend(const BinaryOperator *Assignment, const VarDecl *Var) {
+  const Expr *Addend = nullptr;
+  if (Assignment->getOpcode() == BO_AddAssign) {
+    Addend = Assignment->getRHS();
+  } else if (const auto *Add = dyn_cast<BinaryOperator>(
+                 Assignment->getRHS()->IgnoreParenImpCasts())) {
+    if (Add->getOpcode() != BO_Add)
+      return nullptr;
+    const auto *LHS =
+        dyn_cast<DeclRefExpr>(Add->getLHS()->IgnoreParenImpCasts());
+    const auto *RHS =
+        dyn_cast<DeclRefExpr>(Add->getRHS()->IgnoreParenImpCasts());
+    if (LHS && LHS->getDecl() == Var)
+      Addend = Add->getRHS();
+    else if (RHS && RHS->getDecl() == Var)
+      Addend = Add->getLHS();
+  }
+  if (!Addend || getRecurrenceDepth(Addend, Var))
+    return nullptr;
+  return Addend;
+}
+
+/// Returns true if \p Name is the name of a parameter of \p Func, or of a
+/// variable declared or referenced in its body.
+bool isNameUsed(const FunctionDecl *Func, StringRef Name) {
+  for (const ParmVarDecl *Param : Func->parameters())
+    if (Param->getName() == Name)
+      return true;
+  llvm::SmallVector<const Stmt *, 32> Worklist = {Func->getBody()};
+  while (!Worklist.empty()) {
+    const Stmt *S = Worklist.pop_back_val();
+    if (!S)
+      continue;
+    if (const auto *Decls = dyn_cast<DeclStmt>(S)) {
+      for (const Decl *D : Decls->decls())
+        if (const auto *Named = dyn_cast<NamedDecl>(D))
+          if (Named->getIdentifier() && Named->getName() == Name)
+            return true;
+    } else if (const auto *Ref = dyn_cast<DeclRefExpr>(S)) {
+      if (Ref->getDecl()->getIdentifier() && Ref->getDecl()->getName() == Name)
+        return true;
+    }
+    for (const Stmt *Child : S->children())
+      Worklist.push_back(Child);
+  }
+  return false;
+}
+
+const Stmt *getParentStmt(const Stmt *S, ASTContext &Context) {
+  const auto Parents = Context.getParents(*S);
+  return Parents.empty() ? nullptr : Parents[0].get<Stmt>();
+}
+
+/// Returns the fix-its that rewrite the accumulation \p Assignment of
+/// \p Addend into \p Var in \p Loop into a shift register of \p Length partial
+/// sums, which are added up after the loop. Returns no fix-it if the loop or
+/// the accumulation is not a statement of a block, or if \p Var is used
+/// anywhere else in the loop.
+std::vector<FixItHint>
+getShiftRegisterFix(const Stmt *Loop, const Stmt *Body,
+                    const BinaryOperator *Assignment, const VarDecl *Var,
+                    const Expr *Addend, unsigned Length,
+                    const FunctionDecl *Func, ASTContext &Context) {
+  const SourceManager &SM = Context.getSourceManager();
+  const LangOptions &LangOpts = Context.getLangOpts();
+  const auto *Block = dyn_cast<CompoundStmt>(Body);
+  if (isa<DoStmt>(Loop) || !Block ||
+      !llvm::is_contained(Block->body(), static_cast<const Stmt *>(Assignment)))
+    return {};
+  const Stmt *Parent = getParentStmt(Loop, Context);
+  if (Parent && isa<AttributedStmt>(Parent))
+    Parent = getParentStmt(Parent, Context);
+  if (!Parent || !isa<CompoundStmt>(Parent))
+    return {};
+  const unsigned References =
+      Assignment->getOpcode() == BO_AddAssign ? 1 : 2;
+  if (!Var->hasLocalStorage() ||
+      utils::countReferences(Loop, Var) != References)
+    return {};
+  if (Loop->getBeginLoc().isMacroID() || Loop->getEndLoc().isMacroID() ||
+      Assignment->getBeginLoc().isMacroID() ||
+      Assignment->getEndLoc().isMacroID())
+    return {};
+
+  const std::string Partial = (Var->getName() + "Partial").str();
+  const std::string Index = (Var->getName() + "Index").str();
+  if (isNameUsed(Func, Partial) || isNameUsed(Func, Index))
+    return {};
+  const SourceLocation LoopStart = utils::getStartOfLoopLines(Loop, SM);
+  const SourceLocation AfterAssignment = Lexer::findLocationAfterToken(
+      Assignment->getEndLoc(), tok::semi, SM, LangOpts,
+      /*SkipTrailingWhitespaceAndNewLine=*/false);
+  const SourceLocation AfterLoop =
+      Lexer::getLocForEndOfToken(Loop->getEndLoc(), 0, SM, LangOpts);
+  const StringRef AddendText = Lexer::getSourceText(
+      CharSourceRange::getTokenRange(Addend->getSourceRange()), SM, LangOpts);
+  if (LoopStart.isInvalid() || AfterAssignment.isInvalid() ||
+      AfterLoop.isInvalid() || AddendText.empty())
+    return {};
+
+  const StringRef LoopIndent =
+      Lexer::getIndentationForLine(Loop->getBeginLoc(), SM);
+  const StringRef BodyIndent =
+      Lexer::getIndentationForLine(Assignment->getBeginLoc(), SM);
+  const std::string Type = Var->getType().getUnqualifiedType().getAsString(
+      Context.getPrintingPolicy());
+  const std::string Size = std::to_string(Length);
+  const std::string IndexLoop = "for (int " + Index + " = 0; " + Index +
+                                " < " + Size + "; ++" + Index + ")\n";
+  return {
+      FixItHint::CreateInsertion(LoopStart,
+                                 (LoopIndent + Type + " " + Partial + "[" +
+                                  std::to_string(Length + 1) + "] = {0};\n")
+                                     .str()),
+      FixItHint::CreateReplacement(
+          Assignment->getSourceRange(),
+          (Partial + "[" + Size + "] = " + Partial + "[0] + " + AddendText)
+              .str()),
+      FixItHint::CreateInsertion(
+          AfterAssignment,
+          ("\n" + BodyIndent + "#pragma unroll\n" + BodyIndent + IndexLoop +
+           BodyIndent + "  " + Partial + "[" + Index + "] = " + Partial + "[" +
+           Index + " + 1];")
+              .str()),
+      FixItHint::CreateInsertion(
+          AfterLoop, ("\n" + LoopIndent + "#pragma unroll\n" + LoopIndent +
+                      IndexLoop + LoopIndent + "  " + Var->getName() + " += " +
+                      Partial + "[" + Index + "];")
+                         .str())};
+}
+
+} // namespace
+
+void LoopCarriedDependencyCheck::registerPPCallbacks(
+    const SourceManager &SM, Preprocessor *PP, Preprocessor *ModuleExpanderPP) {
+  PP->addPPCallbacks(
+      std::make_unique<LoopCarriedDependencyPPCallbacks>(*this, SM));
+}
+
+void LoopCarriedDependencyCheck::addLoopPragma(SourceLocation Loc,
+                                               bool IsIvdep,
+                                               const SourceManager &SM) {
+  const std::pair<FileID, unsigned> Decomposed = SM.getDecomposedLoc(Loc);
+  const unsigned Line = SM.getLineNumber(Decomposed.first, Decomposed.second);
+  PragmaLines[{Decomposed.first.getHashValue(), Line}] = IsIvdep;
+}
+
+bool LoopCarriedDependencyCheck::hasIvdep(const Stmt *Loop,
+                                          ASTContext &Context) const {
+  // '#pragma clang loop vectorize(assume_safety)' makes the same promise.
+  for (const LoopHintAttr::OptionType Option :
+       {LoopHintAttr::Vectorize, LoopHintAttr::Interleave})
+    if (const LoopHintAttr *Hint = utils::getLoopHint(Loop, Option, Context))
+      if (Hint->getState() == LoopHintAttr::AssumeSafety)
+        return true;
+  // Otherwise look for '#pragma ivdep' among the directives on the lines
+  // directly preceding the loop.
+  const SourceManager &SM = Context.getSourceManager();
+  const SourceLocation LoopLoc = SM.getExpansionLoc(Loop->getBeginLoc());
+  const std::pair<FileID, unsigned> Decomposed = SM.getDecomposedLoc(LoopLoc);
+  unsigned Line = SM.getLineNumber(Decomposed.first, Decomposed.second);
+  while (--Line > 0) {
+    const auto Found =
+        PragmaLines.find({Decomposed.first.getHashValue(), Line});
+    if (Found == PragmaLines.end())
+      return false;
+    if (Found->second)
+      return true;
+  }
+  return false;
+}
+
+void LoopCarriedDependencyCheck::registerMatchers(MatchFinder *Finder) {
+  // Only innermost loops are pipelined on their own; the dependencies of
+  // outer loops are dominated by the latency of their inner loops.
+  const auto AnyLoop = stmt(anyOf(forStmt(), whileStmt(), doStmt()));
+  Finder->addMatcher(stmt(AnyLoop, unless(hasDescendant(AnyLoop)),
+                          hasAncestor(functionDecl().bind("function")))
+                         .bind("loop"),
+                     this);
+}
+
+void LoopCarriedDependencyCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Loop = Result.Nodes.getNodeAs<Stmt>("loop");
+  const auto *Function = Result.Nodes.getNodeAs<FunctionDecl>("function");
+  ASTContext &Context = *Result.Context;
+  // Fully unrolled loops are not pipelined.
+  if (utils::isFullyUnrolled(Loop, Context))
+    return;
+
+  const Stmt *Body = nullptr;
+  if (const auto *For = dyn_cast<ForStmt>(Loop))
+    Body = For->getBody();
+  else if (const auto *While = dyn_cast<WhileStmt>(Loop))
+    Body = While->getBody();
+  else if (const auto *Do = dyn_cast<DoStmt>(Loop))
+    Body = Do->getBody();
+  if (!Body)
+    return;
+
+  if (!hasIvdep(Loop, Context))
+    checkMemoryDependencies(Loop, Body, Context);
+  checkScalarRecurrences(Loop, Body, Function, Context);
+}
+
+unsigned LoopCarriedDependencyCheck::getMemoryLatency(
+    const VarDecl *Base, const ASTContext &Context) const {
+  QualType Element = Base->getType();
+  if (const auto *Pointer = Element->getAs<PointerType>())
+    Element = Pointer->getPointeeType();
+  else if (const ArrayType *Array = Context.getAsArrayType(Element))
+    Element = Array->getElementType();
+  const LangAS AddressSpace = Element.getAddressSpace();
+  if (AddressSpace == LangAS::opencl_global ||
+      AddressSpace == LangAS::opencl_constant ||
+      AddressSpace == LangAS::opencl_generic)
+    return GlobalMemoryLatency;
+  return LocalMemoryLatency;
+}
+
+void LoopCarriedDependencyCheck::checkMemoryDependencies(const Stmt *Loop,
+                                                         const Stmt *Body,
+                                                         ASTContext &Context) {
+  llvm::SmallVector<const ArraySubscriptExpr *, 8> Reads;
+  llvm::SmallVector<const ArraySubscriptExpr *, 4> Writes;
+  collectAccesses(Body, false, Reads, Writes);
+  if (Writes.empty())
+    return;
+  llvm::Optional<utils::InductionVariable> Induction =
+      utils::getInductionVariable(Loop, Context);
+  if (Induction && Induction->Step == 0)
+    Induction = llvm::None;
+
+  llvm::SmallPtrSet<const VarDecl *, 4> Reported;
+  for (const ArraySubscriptExpr *Write : Writes) {
+    const VarDecl *Base = getArrayBase(Write);
+    if (!Base || Reported.count(Base))
+      continue;
+    const llvm::Optional<AffineIndex> WriteIndex =
+        Induction ? getAffineIndex(Write->getIdx(), Induction->Var, Context)
+                  : llvm::None;
+    for (const ArraySubscriptExpr *Read : Reads) {
+      if (getArrayBase(Read) != Base)
+        continue;
+      const llvm::Optional<AffineIndex> ReadIndex =
+          Induction ? getAffineIndex(Read->getIdx(), Induction->Var, Context)
+                    : llvm::None;
+      if (!WriteIndex || !ReadIndex ||
+          WriteIndex->Coefficient != ReadIndex->Coefficient) {
+        // The compiler has to assume the worst case.
+        diag(Read->getBeginLoc(),
+             "possible loop-carried dependency through %0 with an unknown "
+             "distance; if the elements written and read in different "
+             "iterations never overlap, use '#pragma ivdep'")
+            << Base;
+        if (Read != Write)
+          diag(Write->getBeginLoc(), "%0 is written here",
+               DiagnosticIDs::Note)
+              << Base;
+        Reported.insert(Base);
+        break;
+      }
+
+      // The element written when the induction variable is V is read when it
+      // is V + (WriteOffset - ReadOffset) / Coefficient.
+      const int64_t Coefficient = WriteIndex->Coefficient;
+      const int64_t Difference = WriteIndex->Offset - ReadIndex->Offset;
+      if (Coefficient == 0 || Difference % Coefficient != 0)
+        continue;
+      const int64_t VarDistance = Difference / Coefficient;
+      if (VarDistance % Induction->Step != 0)
+        continue;
+      const int64_t Distance = VarDistance / Induction->Step;
+      if (Distance <= 0)
+        continue;
+      const unsigned Latency = getMemoryLatency(Base, Context);
+      const uint64_t II = (Latency + Distance - 1) / Distance;
+      if (II <= 1)
+        continue;
+      diag(Read->getBeginLoc(),
+           "loop-carried dependency through %0: an element written in one "
+           "iteration is read %1 iteration%s1 later, which limits the "
+           "initiation interval to about %2; keep the last %1 value%s1 in a "
+           "shift register instead of reading them back from memory")
+          << Base << static_cast<unsigned>(Distance)
+          << static_cast<unsigned>(II);
+      diag(Write->getBeginLoc(), "%0 is written here", DiagnosticIDs::Note)
+          << Base;
+      Reported.insert(Base);
+      break;
+    }
+  }
+}
+
+void LoopCarriedDependencyCheck::checkScalarRecurrences(
+    const Stmt *Loop, const Stmt *Body, const FunctionDecl *Function,
+    ASTContext &Context) {
+  llvm::SmallVector<const Stmt *, 16> Worklist = {Body};
+  llvm::SmallVector<const BinaryOperator *, 8> Assignments;
+  // Variables declared in the body start afresh in every iteration.
+  llvm::SmallPtrSet<const VarDecl *, 8> BodyVars;
+  while (!Worklist.empty()) {
+    const Stmt *S = Worklist.pop_back_val();
+    if (!S)
+      continue;
+    for (const Stmt *Child : S->children())
+      Worklist.push_back(Child);
+    if (const auto *Decls = dyn_cast<DeclStmt>(S)) {
+      for (const Decl *D : Decls->decls())
+        if (const auto *Var = dyn_cast<VarDecl>(D))
+          BodyVars.insert(Var);
+    } else if (const auto *BinOp = dyn_cast<BinaryOperator>(S)) {
+      if (BinOp->isAssignmentOp())
+        Assignments.push_back(BinOp);
+    }
+  }
+
+  llvm::SmallPtrSet<const VarDecl *, 4> Reported;
+  for (const BinaryOperator *Assignment : llvm::reverse(Assignments)) {
+    const auto *Ref =
+        dyn_cast<DeclRefExpr>(Assignment->getLHS()->IgnoreParens());
+    const auto *Var = Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+    if (!Var || BodyVars.count(Var) || !isFloatingType(Var->getType()) ||
+        Reported.count(Var))
+      continue;
+
+    llvm::Optional<unsigned> Depth =
+        getRecurrenceDepth(Assignment->getRHS(), Var);
+    switch (Assignment->getOpcode()) {
+    case BO_Assign:
+      break;
+    case BO_AddAssign:
+    case BO_SubAssign:
+    case BO_MulAssign:
+    case BO_DivAssign:
+      Depth = Depth.getValueOr(0) + 1;
+      break;
+    default:
+      continue;
+    }
+    if (!Depth || *Depth == 0)
+      continue;
+
+    const unsigned II = *Depth * FloatingPointLatency;
+    if (II <= 1)
+      continue;
+    auto Diag = diag(Assignment->getOperatorLoc(),
+                     "floating-point accumulation into %0 is a loop-carried "
+                     "dependency through %1 operation%s1, which limits the "
+                     "initiation interval to about %2; accumulate %2 partial "
+                     "results in a shift register and add them up after the "
+                     "loop")
+                << Var << *Depth << II;
+    // A sum of values that do not depend on it, such as a dot product, can be
+    // rewritten automatically.
+    if (*Depth == 1)
+      if (const Expr *Addend = getAddend(Assignment, Var))
+        Diag << getShiftRegisterFix(Loop, Body, Assignment, Var, Addend, II,
+                                    Function, Context);
+    Reported.insert(Var);
+  }
+}
+
+void LoopCarriedDependencyCheck::storeOptions(
+    ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "GlobalMemoryLatency", GlobalMemoryLatency);
+  Options.store(Opts, "LocalMemoryLatency", LocalMemoryLatency);
+  Options.store(Opts, "FloatingPointLatency", FloatingPointLatency);
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,72 @@
+//===--- LoopCarriedDependencyCheck.h - clang-tidy --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_LOOPCARRIEDDEPENDENCYCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_LOOPCARRIEDDEPENDENCYCHECK_H
+
+#include "../ClangTidy.h"
+#include <map>
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Finds dependencies between the iterations of pipelined loops that prevent
+/// them from being launched at an initiation interval (II) of 1: array
+/// elements read a few iterations after they are written, and floating-point
+/// accumulations. Estimates the resulting II from the configured latencies.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-loop-carried-dependency.html
+class LoopCarriedDependencyCheck : public ClangTidyCheck {
+  const unsigned GlobalMemoryLatency;
+  const unsigned LocalMemoryLatency;
+  const unsigned FloatingPointLatency;
+
+public:
+  LoopCarriedDependencyCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context),
+        GlobalMemoryLatency(Options.get("GlobalMemoryLatency", 100U)),
+        LocalMemoryLatency(Options.get("LocalMemoryLatency", 5U)),
+        FloatingPointLatency(Options.get("FloatingPointLatency", 4U)) {}
+  void registerPPCallbacks(const SourceManager &SM, Preprocessor *PP,
+                           Preprocessor *ModuleExpanderPP) override;
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
+  /// Records a #pragma directive, which may apply to the loop that follows it.
+  void addLoopPragma(SourceLocation Loc, bool IsIvdep,
+                     const SourceManager &SM);
+
+private:
+  /// The lines of the #pragma directives of the translation unit, by file,
+  /// and whether each is a #pragma ivdep.
+  std::map<std::pair<unsigned, unsigned>, bool> PragmaLines;
+
+  /// Returns true if the programmer promised that \p Loop has no loop-carried
+  /// memory dependencies, with #pragma ivdep or its clang equivalent.
+  bool hasIvdep(const Stmt *Loop, ASTContext &Context) const;
+  /// Reports array elements that are read in a later iteration than the one
+  /// that writes them.
+  void checkMemoryDependencies(const Stmt *Loop, const Stmt *Body,
+                               ASTContext &Context);
+  /// Reports floating-point variables that accumulate a value across
+  /// iterations, with a fix-it for plain sums.
+  void checkScalarRecurrences(const Stmt *Loop, const Stmt *Body,
+                              const FunctionDecl *Function,
+                              ASTContext &Context);
+  /// Returns the latency of a store followed by a load of the given array.
+  unsigned getMemoryLatency(const VarDecl *Base,
+                            const ASTContext &Context) const;
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_LOOPCARRIEDDEPENDENCYCHECK_H
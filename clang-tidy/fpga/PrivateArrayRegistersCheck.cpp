@@ -0,0 +1,262 @@
+//===--- PrivateArrayRegistersCheck.cpp - clang-tidy ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "PrivateArrayRegistersCheck.h"
+#include "UnrollLoopsCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LoopUtils.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+/// Why the index of an access is not a constant after unrolling.
+struct Blocker {
+  enum BlockerKind {
+    /// The index depends on the counter of a loop that is not fully unrolled
+    /// but could be.
+    UnrollableLoop,
+    /// The index depends on the counter of a loop that cannot be fully
+    /// unrolled, because its trip count is unknown or too large.
+    PipelinedLoop,
+    /// The index depends on a variable that is not a loop counter.
+    Variable,
+    /// The index is computed from a call or a memory access.
+    Computed
+  };
+  BlockerKind Kind = Computed;
+  const Expr *Index = nullptr;
+  const VarDecl *Var = nullptr;
+  uint64_t TripCount = 0;
+};
+
+bool isPrivateArray(const VarDecl *Var, const ASTContext &Context) {
+  if (!Var->hasLocalStorage() || isa<ParmVarDecl>(Var) ||
+      !Var->getType()->isConstantArrayType())
+    return false;
+  const LangAS AddressSpace =
+      Context.getBaseElementType(Var->getType()).getAddressSpace();
+  return AddressSpace == LangAS::Default ||
+         AddressSpace == LangAS::opencl_private;
+}
+
+class IndexAnalyzer {
+public:
+  IndexAnalyzer(const FunctionDecl *Func, unsigned MaxUnrollIterations,
+                ASTContext &Context)
+      : MaxUnrollIterations(MaxUnrollIterations), Context(Context) {
+    utils::collectModifiedVars(Func->getBody(), Modified);
+  }
+
+  /// Returns why \p Index, the subscript of \p Access, is not a constant once
+  /// the fully unrolled loops around \p Access are unrolled, or None if it is.
+  llvm::Optional<Blocker> findBlocker(const Expr *Index, const Expr *Access,
+                                      unsigned Depth = 0) const;
+
+private:
+  /// Returns the loop around \p Access whose induction variable is \p Var.
+  const Stmt *findInductionLoop(const Expr *Access, const VarDecl *Var) const;
+
+  const unsigned MaxUnrollIterations;
+  ASTContext &Context;
+  llvm::SmallPtrSet<const VarDecl *, 16> Modified;
+};
+
+const Stmt *IndexAnalyzer::findInductionLoop(const Expr *Access,
+                                             const VarDecl *Var) const {
+  ast_type_traits::DynTypedNode Node =
+      ast_type_traits::DynTypedNode::create(*Access);
+  while (true) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() || Parents[0].get<FunctionDecl>())
+      return nullptr;
+    Node = Parents[0];
+    const auto *Loop = Node.get<Stmt>();
+    if (!Loop || !utils::isLoop(Loop))
+      continue;
+    const llvm::Optional<utils::InductionVariable> Induction =
+        utils::getInductionVariable(Loop, Context);
+    if (Induction && Induction->Var == Var)
+      return Loop;
+  }
+}
+
+llvm::Optional<Blocker> IndexAnalyzer::findBlocker(const Expr *Index,
+                                                   const Expr *Access,
+                                                   unsigned Depth) const {
+  if (utils::evaluateInteger(Index, Context))
+    return llvm::None;
+  const Expr *E = Index->IgnoreParenImpCasts();
+  Blocker Result;
+  Result.Index = Index;
+
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E)) {
+    const auto *Var = dyn_cast<VarDecl>(Ref->getDecl());
+    if (!Var)
+      return llvm::None;
+    Result.Var = Var;
+    if (const Stmt *Loop = findInductionLoop(Access, Var)) {
+      const llvm::Optional<uint64_t> TripCount =
+          utils::getTripCount(Loop, Context);
+      const llvm::Optional<uint64_t> Factor =
+          UnrollLoopsCheck::getUnrollFactor(Loop, &Context);
+      // A loop is fully unrolled by '#pragma unroll', or by a factor that is
+      // at least its trip count.
+      if (Factor &&
+          (UnrollLoopsCheck::unrollType(Loop, &Context) ==
+               UnrollLoopsCheck::FullyUnrolled ||
+           (TripCount && *Factor >= *TripCount)))
+        return llvm::None;
+      Result.Kind = TripCount && *TripCount <= MaxUnrollIterations
+                        ? Blocker::UnrollableLoop
+                        : Blocker::PipelinedLoop;
+      Result.TripCount = TripCount.getValueOr(0);
+      return Result;
+    }
+    // A variable that is only given a value by its initializer is as constant
+    // as its initializer.
+    if (Var->hasLocalStorage() && !isa<ParmVarDecl>(Var) && Var->getInit() &&
+        !Modified.count(Var) && Depth < 8) {
+      llvm::Optional<Blocker> Init =
+          findBlocker(Var->getInit(), Access, Depth + 1);
+      if (Init)
+        Init->Index = Index;
+      return Init;
+    }
+    Result.Kind = Blocker::Variable;
+    return Result;
+  }
+
+  if (isa<CallExpr>(E) || isa<ArraySubscriptExpr>(E) || isa<MemberExpr>(E))
+    return Result;
+  if (const auto *Unary = dyn_cast<UnaryOperator>(E))
+    if (Unary->getOpcode() == UO_Deref)
+      return Result;
+  for (const Stmt *Child : E->children())
+    if (const auto *ChildExpr = dyn_cast_or_null<Expr>(Child))
+      if (llvm::Optional<Blocker> Found =
+              findBlocker(ChildExpr, Access, Depth)) {
+        Found->Index = Index;
+        return Found;
+      }
+  return llvm::None;
+}
+
+} // namespace
+
+void PrivateArrayRegistersCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("kernel"),
+      this);
+}
+
+void PrivateArrayRegistersCheck::check(
+    const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+
+  llvm::SmallVector<utils::MemoryAccess, 32> Accesses;
+  utils::collectMemoryAccesses(Kernel->getBody(), Accesses);
+  llvm::MapVector<const VarDecl *,
+                  llvm::SmallVector<const utils::MemoryAccess *, 8>>
+      Arrays;
+  for (const utils::MemoryAccess &Access : Accesses)
+    if (isPrivateArray(Access.Base, Context))
+      Arrays[Access.Base].push_back(&Access);
+
+  const IndexAnalyzer Analyzer(Kernel, MaxUnrollIterations, Context);
+  for (const auto &Entry : Arrays) {
+    const VarDecl *Array = Entry.first;
+    // An array whose address escapes, for example to a function, is placed
+    // in memory anyway.
+    if (utils::countReferences(Kernel->getBody(), Array) != Entry.second.size())
+      continue;
+
+    llvm::SmallVector<Blocker, 4> Blockers;
+    for (const utils::MemoryAccess *Access : Entry.second) {
+      // Every subscript of a multi-dimensional access has to be constant.
+      llvm::SmallVector<const Expr *, 3> Indices;
+      const Expr *Base = Access->Access;
+      while (const auto *Subscript =
+                 dyn_cast<ArraySubscriptExpr>(Base->IgnoreParenImpCasts())) {
+        Indices.insert(Indices.begin(), Subscript->getIdx());
+        Base = Subscript->getBase();
+      }
+      if (Indices.empty() && Access->Index)
+        Indices.push_back(Access->Index);
+      for (const Expr *Index : Indices)
+        if (llvm::Optional<Blocker> Found =
+                Analyzer.findBlocker(Index, Access->Access)) {
+          Blockers.push_back(*Found);
+          break;
+        }
+    }
+    if (Blockers.empty())
+      continue;
+
+    const bool Unrollable =
+        llvm::all_of(Blockers, [](const Blocker &B) {
+          return B.Kind == Blocker::UnrollableLoop;
+        });
+    diag(Array->getLocation(),
+         "private array %0 is implemented in block RAM instead of registers "
+         "because it is indexed with values that are not constant after "
+         "unrolling%select{|; fully unrolling the loops noted below would let "
+         "it live in registers}1")
+        << Array << Unrollable;
+    for (const Blocker &B : Blockers) {
+      switch (B.Kind) {
+      case Blocker::UnrollableLoop:
+        diag(B.Index->getBeginLoc(),
+             "index depends on %0, the counter of a loop with %1 iterations "
+             "that is not fully unrolled",
+             DiagnosticIDs::Note)
+            << B.Var << static_cast<unsigned>(B.TripCount);
+        break;
+      case Blocker::PipelinedLoop:
+        diag(B.Index->getBeginLoc(),
+             "index depends on %0, the counter of a loop that cannot be fully "
+             "unrolled",
+             DiagnosticIDs::Note)
+            << B.Var;
+        break;
+      case Blocker::Variable:
+        diag(B.Index->getBeginLoc(),
+             "index depends on %0, which is not known at compile time",
+             DiagnosticIDs::Note)
+            << B.Var;
+        break;
+      case Blocker::Computed:
+        diag(B.Index->getBeginLoc(),
+             "index is computed from a call or a memory access",
+             DiagnosticIDs::Note);
+        break;
+      }
+    }
+  }
+}
+
+void PrivateArrayRegistersCheck::storeOptions(
+    ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "MaxUnrollIterations", MaxUnrollIterations);
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,41 @@
+//===--- PrivateArrayRegistersCheck.h - clang-tidy --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_PRIVATEARRAYREGISTERSCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_PRIVATEARRAYREGISTERSCHECK_H
+
+#include "../ClangTidy.h"
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Finds private arrays that are indexed with values that are not constant
+/// once the fully unrolled loops are unrolled. The compiler implements such
+/// arrays in block RAM instead of registers. Reports the indices that prevent
+/// the promotion, and the loops whose full unrolling would allow it.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-private-array-registers.html
+class PrivateArrayRegistersCheck : public ClangTidyCheck {
+  const unsigned MaxUnrollIterations;
+
+public:
+  PrivateArrayRegistersCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context),
+        MaxUnrollIterations(Options.get("MaxUnrollIterations", 100U)) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_PRIVATEARRAYREGISTERSCHECK_H
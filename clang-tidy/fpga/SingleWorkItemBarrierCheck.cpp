@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "SingleWorkItemBarrierCheck.h"
+#include "../utils/KernelClassifier.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 
@@ -18,71 +19,47 @@ namespace tidy {
 namespace FPGA {
 
 void SingleWorkItemBarrierCheck::registerMatchers(MatchFinder *Finder) {
-  // Find any function that calls barrier but does not call either get_local_id
-  // or get_global_id, and will thus be treated as a single-work-item kernel
-  // hasAttr(attr::Kind::OpenCLKernel) restricts it to only kernel functions
-  // TODO: Have it accept all functions but check for a parameter that gets an
-  // ID from one of the two ID functions
+  // Find every OpenCL kernel; whether it calls a barrier or an ID function,
+  // possibly through the functions it calls, is decided by the classifier.
   Finder->addMatcher(
-    // Find function declarations
-    functionDecl(allOf(
-      // That are OpenCL kernels
-      hasAttr(attr::Kind::OpenCLKernel),
-      // And call a barrier function (either 1.x or 2.x version)
-      forEachDescendant(callExpr(callee(
-        functionDecl(anyOf(
-          hasName("barrier"),
-          hasName("work_group_barrier")
-        ))
-      )).bind("barrier")),
-      //But do not call an ID function
-      unless(hasDescendant(callExpr(callee(
-        functionDecl(anyOf(
-          hasName("get_global_id"),
-          hasName("get_local_id")
-        ))
-      ))))
-    )).bind("function"), this);
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("function"),
+      this);
 }
 
 void SingleWorkItemBarrierCheck::check(const MatchFinder::MatchResult &Result) {
   const auto *MatchedDecl = Result.Nodes.getNodeAs<FunctionDecl>("function");
-  const auto *MatchedBarrier = Result.Nodes.getNodeAs<CallExpr>("barrier");
+  utils::KernelClassifier &Classifier =
+      getTranslationUnitAnalysis<utils::KernelClassifier>();
+  const utils::KernelClassifier::KernelInfo &Info =
+      Classifier.classify(MatchedDecl, *Result.Context);
+  // A kernel that obtains its ID, even in a helper function, is an NDRange.
+  if (!Info.IDCalls.empty())
+    return;
   // If reqd_work_group_size is anything other than (1,1,1), it will be
   // interpreted as an NDRange in AOC version 17.1.
-  bool IsNDRange = false;
-  for (Attr * Attribute : MatchedDecl->getAttrs()) {
-    if (Attribute->getKind() == attr::Kind::ReqdWorkGroupSize) {
-      auto RWGSAttribute = static_cast<const ReqdWorkGroupSizeAttr*>(Attribute);
-      if (RWGSAttribute->getXDim() > 1 || RWGSAttribute->getYDim() > 1 ||
-          RWGSAttribute->getZDim() > 1) {
-        IsNDRange = true;
-      }
-      break;
+  if (AOCVersion >= 1701 && Info.HasWorkGroupSize)
+    return;
+  for (const CallExpr *MatchedBarrier : Info.Barriers) {
+    if (AOCVersion < 1701) {
+      diag(MatchedDecl->getLocation(),
+           "Kernel function %0 does not call get_global_id or get_local_id "
+           "and will be treated as single-work-item.\nBarrier call at %1 may "
+           "error out")
+          << MatchedDecl
+          << MatchedBarrier->getBeginLoc().printToString(
+                 Result.Context->getSourceManager());
+    } else {
+      diag(MatchedDecl->getLocation(),
+           "Kernel function %0 does not call get_global_id or get_local_id may "
+           "be a viable single work-item kernel, but barrier call at %1 will "
+           "force NDRange execution. If single work-item semantics are "
+           "desired a mem_fence may be more efficient.")
+          << MatchedDecl
+          << MatchedBarrier->getBeginLoc().printToString(
+                 Result.Context->getSourceManager());
     }
   }
-  if (AOCVersion < 1701) {
-    diag(MatchedDecl->getLocation(),
-         "Kernel function %0 does not call get_global_id or get_local_id and "
-         "will be treated as single-work-item.\nBarrier call at %1 may error "
-         "out")
-        << MatchedDecl
-        << MatchedBarrier->getBeginLoc().printToString(
-                Result.Context->getSourceManager());
-  } else {
-    if (IsNDRange == true) {  // No warning if kernel is treated as an NDRange
-      return;
-    }
-    diag(MatchedDecl->getLocation(), 
-         "Kernel function %0 does not call get_global_id or get_local_id may "
-         "be a viable single work-item kernel, but barrier call at %1 will "
-         "force NDRange execution. If single work-item semantics are desired a "
-         "mem_fence may be more efficient.")
-        << MatchedDecl
-        << MatchedBarrier->getBeginLoc().printToString(
-                Result.Context->getSourceManager());
-
-  }
 }
 
 void SingleWorkItemBarrierCheck::storeOptions(
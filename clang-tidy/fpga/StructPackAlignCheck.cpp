@@ -7,14 +7,13 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef MAX_ALIGN_POWER_OF_TWO
-#define MAX_ALIGN_POWER_OF_TWO 7
-#endif
-
 #include "StructPackAlignCheck.h"
+#include "../../clang-reorder-fields/ReorderFieldsAction.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/RecordLayout.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
 
 using namespace clang::ast_matchers;
 
@@ -22,6 +21,25 @@ namespace clang {
 namespace tidy {
 namespace FPGA {
 
+namespace {
+
+struct FieldInfo {
+  const FieldDecl *Field;
+  CharUnits Size;
+  CharUnits Align;
+};
+
+/// Returns the number of memory words of \p Width bytes that an object of
+/// \p Size bytes, aligned to \p Align bytes, spans at worst.
+uint64_t getMemoryWords(uint64_t Size, uint64_t Align, uint64_t Width) {
+  // An object aligned to less than a word can start at any multiple of its
+  // alignment within a word.
+  const uint64_t Offset = Align < Width ? Width - Align : 0;
+  return llvm::divideCeil(Size + Offset, Width);
+}
+
+} // namespace
+
 void StructPackAlignCheck::registerMatchers(MatchFinder *Finder) {
   Finder->addMatcher(recordDecl(isStruct()).bind("struct"), this);
 }
@@ -34,38 +52,56 @@ void StructPackAlignCheck::check(const MatchFinder::MatchResult &Result) {
   if (Struct != StructDef) return;
   
   // Get sizing info for the struct
-  std::vector<std::pair<unsigned int, unsigned int>> FieldSizes;
+  std::vector<FieldInfo> Fields;
   unsigned int TotalBitSize = 0;
+  bool CanReorder = true;
   for (auto StructField : Struct->fields()) {  
-    // For each StructField, record how big it is (in bits)
-    // Would be good to use a pair of <offset, size> to advise a better 
-    // packing order
+    // For each StructField, record how big it is (in bits) and how it has to
+    // be aligned
     unsigned int StructFieldWidth = (unsigned int)Result.Context->getTypeInfo(
         StructField->getType().getTypePtr()).Width;
-    FieldSizes.push_back(std::pair<unsigned int, unsigned int>(
-                         StructFieldWidth, StructField->getFieldIndex()));
-    // TODO: Recommend a reorganization of the struct (sort by StructField size, 
-    // largest to smallest)
+    // Bit-fields share their storage, and a flexible array member has to stay
+    // last, so neither can be moved around freely. Neither can fields that
+    // are declared together, as in "int a, b;".
+    if (StructField->isBitField() ||
+        StructField->getType()->isIncompleteType() ||
+        StructField->getBeginLoc().isMacroID() ||
+        (!Fields.empty() &&
+         Fields.back().Field->getBeginLoc() == StructField->getBeginLoc()))
+      CanReorder = false;
+    else
+      Fields.push_back({StructField,
+                        Result.Context->getTypeSizeInChars(
+                            StructField->getType()),
+                        Result.Context->getDeclAlign(StructField)});
     TotalBitSize += StructFieldWidth;
   }
-  // TODO: Express this as CharUnit rather than a hardcoded 8-bits (Rshift3)i
   // After computing the minimum size in bits, check for an existing alignment
   // flag
-  CharUnits CurrSize = Result.Context->getASTRecordLayout(Struct).getSize();
-  CharUnits MinByteSize = CharUnits::fromQuantity((TotalBitSize +7) >> 3);
-  CharUnits CurrAlign = Result.Context->getASTRecordLayout(
-      Struct).getAlignment();
+  const ASTContext &Context = *Result.Context;
+  CharUnits CurrSize = Context.getASTRecordLayout(Struct).getSize();
+  CharUnits MinByteSize = Context.toCharUnitsFromBits(
+      llvm::alignTo(TotalBitSize, Context.getCharWidth()));
+  CharUnits CurrAlign = Context.getASTRecordLayout(Struct).getAlignment();
+  if (MinByteSize.isZero())
+    return;
+
+  // Aligning beyond the width of a memory word gains nothing, since a larger
+  // struct spans several words anyway.
+  const CharUnits WordWidth = CharUnits::fromQuantity(llvm::PowerOf2Floor(
+      std::max(1U, BankWidth ? std::min(MemoryInterfaceWidth, BankWidth)
+                             : MemoryInterfaceWidth)));
   CharUnits NewAlign = CharUnits::fromQuantity(1);
   if (!MinByteSize.isPowerOfTwo()) {
     int MSB = (int)MinByteSize.getQuantity();
     for (; MSB > 0; MSB >>= 1) {
       NewAlign = NewAlign.alignTo(CharUnits::fromQuantity(
                                   ((int)NewAlign.getQuantity()) << 1));
-      //Abort if the computed alignment meets the maximum configured alignment
-      if (NewAlign.getQuantity() >= (1 << MAX_ALIGN_POWER_OF_TWO)) break; 
+      //Abort if the computed alignment meets the width of a memory word
+      if (NewAlign >= WordWidth) break; 
     }
   } else {
-    NewAlign = MinByteSize;
+    NewAlign = std::min(MinByteSize, WordWidth);
   }
   
   // Check if struct has a "packed" attribute
@@ -79,11 +115,55 @@ void StructPackAlignCheck::check(const MatchFinder::MatchResult &Result) {
     }
   }
 
-  // If it's using much more space than it needs, suggest packing.
-  // (Do not suggest packing if it is currently explicitly aligned to what the
-  // minimum byte size would suggest as the new alignment)
-  if (MinByteSize < CurrSize && 
-      ((Struct->getMaxAlignment()>>3) != NewAlign.getQuantity()) && 
+  // Ordering the fields by decreasing alignment, then size, leaves no padding
+  // between them, which is the smallest size reachable without packing.
+  // Packing instead would create unaligned load-store units.
+  std::vector<FieldInfo> Reordered = Fields;
+  std::stable_sort(Reordered.begin(), Reordered.end(),
+                   [](const FieldInfo &LHS, const FieldInfo &RHS) {
+                     if (LHS.Align != RHS.Align)
+                       return LHS.Align > RHS.Align;
+                     return LHS.Size > RHS.Size;
+                   });
+  CharUnits ReorderedSize = CharUnits::Zero();
+  for (const FieldInfo &Field : Reordered)
+    ReorderedSize = ReorderedSize.alignTo(Field.Align) + Field.Size;
+  ReorderedSize = ReorderedSize.alignTo(CurrAlign);
+
+  if (CanReorder && !IsPacked && ReorderedSize < CurrSize) {
+    auto Diag = diag(Struct->getLocation(),
+                     "struct %0 has inefficient access due to padding, only "
+                     "needs %1 bytes but is using %2 bytes; reordering its "
+                     "fields by alignment reduces it to %3 bytes without "
+                     "packing")
+                << Struct << (int)MinByteSize.getQuantity()
+                << (int)CurrSize.getQuantity()
+                << (int)ReorderedSize.getQuantity();
+    SmallVector<unsigned, 8> NewFieldsOrder;
+    for (const FieldInfo &Field : Reordered)
+      NewFieldsOrder.push_back(Field.Field->getFieldIndex());
+    std::map<std::string, tooling::Replacements> Replacements;
+    if (reorder_fields::reorderFields(StructDef, NewFieldsOrder,
+                                      *Result.Context, Replacements)) {
+      SourceManager &SM = *Result.SourceManager;
+      for (const auto &FileAndReplacements : Replacements) {
+        auto File = SM.getFileManager().getFile(FileAndReplacements.first);
+        if (!File)
+          continue;
+        SourceLocation FileStart =
+            SM.getLocForStartOfFile(SM.getOrCreateFileID(*File,
+                                                         SrcMgr::C_User));
+        for (const tooling::Replacement &R : FileAndReplacements.second) {
+          SourceLocation Begin = FileStart.getLocWithOffset(R.getOffset());
+          Diag << FixItHint::CreateReplacement(
+              CharSourceRange::getCharRange(
+                  Begin, Begin.getLocWithOffset(R.getLength())),
+              R.getReplacementText());
+        }
+      }
+    }
+  } else if (MinByteSize < CurrSize && 
+      (Context.toCharUnitsFromBits(Struct->getMaxAlignment()) != NewAlign) && 
       (CurrSize != NewAlign) && 
       !IsPacked) {
     diag(Struct->getLocation(), 
@@ -95,8 +175,16 @@ void StructPackAlignCheck::check(const MatchFinder::MatchResult &Result) {
   }
 
   // And suggest the minimum power-of-two alignment for the struct as a whole
-  // (with and without packing)
-  if (CurrAlign.getQuantity() != NewAlign.getQuantity()) {
+  // (with and without packing). A larger alignment is only worth it if an
+  // access then spans fewer memory words.
+  const uint64_t Width = WordWidth.getQuantity();
+  const uint64_t Useful = MinByteSize.getQuantity();
+  const uint64_t CurrWords = getMemoryWords(
+      CurrSize.getQuantity(), CurrAlign.getQuantity(), Width);
+  const uint64_t NewWords =
+      getMemoryWords(Useful, NewAlign.getQuantity(), Width);
+  if (CurrAlign.getQuantity() != NewAlign.getQuantity() &&
+      (NewAlign < CurrAlign || NewWords < CurrWords)) {
     diag(Struct->getLocation(), 
          "struct %0 has inefficient access due to poor alignment. Currently "
          "aligned to %1 bytes, but size %3 bytes is large enough to benefit "
@@ -105,9 +193,28 @@ void StructPackAlignCheck::check(const MatchFinder::MatchResult &Result) {
 	    << (int)CurrAlign.getQuantity()
 	    << (int)NewAlign.getQuantity()
 	    << (int)MinByteSize.getQuantity(); 
+
+    // Report how well the memory transactions are used, now and with the
+    // recommended alignment.
+    const uint64_t Stride = MinByteSize.alignTo(NewAlign).getQuantity();
+    diag(Struct->getLocation(),
+         "aligned to %0 bytes, an access to %1 transfers %2 useful bytes per "
+         "%3-byte memory transaction instead of %4, and a %5-byte burst holds "
+         "%6 of them",
+         DiagnosticIDs::Note)
+        << (int)NewAlign.getQuantity() << Struct
+        << (unsigned)(Useful / NewWords) << (unsigned)Width
+        << (unsigned)(Useful / CurrWords) << (unsigned)(Width * BurstSize)
+        << (unsigned)(Width * BurstSize / Stride);
   }
 }
 
+void StructPackAlignCheck::storeOptions(ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "MemoryInterfaceWidth", MemoryInterfaceWidth);
+  Options.store(Opts, "BankWidth", BankWidth);
+  Options.store(Opts, "BurstSize", BurstSize);
+}
+
 } // namespace FPGA
 } // namespace tidy
 } // namespace clang
@@ -19,14 +19,26 @@ namespace FPGA {
 /// Finds structs that are inefficiently packed or aligned, and recommends
 /// packing and/or aligning of said structs as needed.
 ///
+/// The recommended alignment is capped by the width of the memory words of
+/// the target board, given by the MemoryInterfaceWidth and BankWidth options
+/// in bytes. BurstSize is the number of memory words in a burst.
+///
 /// For the user-facing documentation see:
 /// http://clang.llvm.org/extra/clang-tidy/checks/FPGA-struct-pack-align.html
 class StructPackAlignCheck : public ClangTidyCheck {
+  const unsigned MemoryInterfaceWidth;
+  const unsigned BankWidth;
+  const unsigned BurstSize;
+
 public:
   StructPackAlignCheck(StringRef Name, ClangTidyContext *Context)
-      : ClangTidyCheck(Name, Context) {}
+      : ClangTidyCheck(Name, Context),
+        MemoryInterfaceWidth(Options.get("MemoryInterfaceWidth", 64U)),
+        BankWidth(Options.get("BankWidth", 64U)),
+        BurstSize(Options.get("BurstSize", 16U)) {}
   void registerMatchers(ast_matchers::MatchFinder *Finder) override;
   void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
 };
 
 } // namespace FPGA
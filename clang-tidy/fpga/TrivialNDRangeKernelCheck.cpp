@@ -0,0 +1,48 @@
+//===--- TrivialNDRangeKernelCheck.cpp - clang-tidy -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TrivialNDRangeKernelCheck.h"
+#include "../utils/KernelClassifier.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+void TrivialNDRangeKernelCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("kernel"),
+      this);
+}
+
+void TrivialNDRangeKernelCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  utils::KernelClassifier &Classifier =
+      getTranslationUnitAnalysis<utils::KernelClassifier>();
+  const utils::KernelClassifier::KernelInfo &Info =
+      Classifier.classify(Kernel, *Result.Context);
+  if (!Info.isTrivialNDRange(*Result.Context))
+    return;
+
+  diag(Kernel->getLocation(),
+       "NDRange kernel %0 only uses the work-item ID as get_global_id(0); "
+       "consider converting it into a single-work-item kernel that loops over "
+       "the work-items, which the compiler can pipeline")
+      << Kernel;
+  for (const CallExpr *Call : Info.IDCalls)
+    diag(Call->getBeginLoc(), "the work-item ID is read here",
+         DiagnosticIDs::Note);
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,37 @@
+//===--- TrivialNDRangeKernelCheck.h - clang-tidy ---------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_TRIVIALNDRANGEKERNELCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_TRIVIALNDRANGEKERNELCHECK_H
+
+#include "../ClangTidy.h"
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+/// Finds NDRange kernels that only use the work-item ID as ``get_global_id(0)``
+/// and neither synchronize nor share local memory between work-items, and
+/// suggests rewriting them as single-work-item kernels with a loop, which the
+/// offline compiler can pipeline.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/fpga-trivial-ndrange-kernel.html
+class TrivialNDRangeKernelCheck : public ClangTidyCheck {
+public:
+  TrivialNDRangeKernelCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+};
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_TRIVIALNDRANGEKERNELCHECK_H
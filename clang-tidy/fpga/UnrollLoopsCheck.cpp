@@ -7,8 +7,17 @@
 //===----------------------------------------------------------------------===//
 
 #include "UnrollLoopsCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LoopUtils.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Basic/CharInfo.h"
+#include "clang/Lex/Lexer.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "clang/Lex/Preprocessor.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <limits>
 
 using namespace clang::ast_matchers;
 
@@ -16,31 +25,209 @@ namespace clang {
 namespace tidy {
 namespace FPGA {
 
+namespace {
+class UnrollLoopsPPCallbacks : public PPCallbacks {
+public:
+  UnrollLoopsPPCallbacks(UnrollLoopsCheck &Check, const SourceManager &SM)
+      : Check(Check), SM(SM) {}
+
+  void PragmaDirective(SourceLocation Loc,
+                       PragmaIntroducerKind Introducer) override {
+    if (Introducer != PIK_HashPragma || !Loc.isFileID()) {
+      return;
+    }
+    // The FPGA loop pragmas (ii, ivdep, loop_coalesce, ...) are unknown to
+    // clang, so they are read from the source text.
+    const std::pair<FileID, unsigned> decomposed = SM.getDecomposedLoc(Loc);
+    bool invalid = false;
+    StringRef text = SM.getBufferData(decomposed.first, &invalid);
+    if (invalid) {
+      return;
+    }
+    text = text.substr(decomposed.second);
+    text = text.substr(0, text.find_first_of("\r\n")).drop_front().ltrim();
+    if (!text.consume_front("pragma")) {
+      return;
+    }
+    text = text.ltrim();
+    const StringRef name = text.take_while([](char c) { return isIdentifierBody(c); });
+    if (!name.empty()) {
+      Check.addLoopPragma(Loc, name, text.drop_front(name.size()).trim(), SM);
+    }
+  }
+
+private:
+  UnrollLoopsCheck &Check;
+  const SourceManager &SM;
+};
+} // namespace
+
+void UnrollLoopsCheck::registerPPCallbacks(const SourceManager &SM,
+    Preprocessor *PP, Preprocessor *ModuleExpanderPP) {
+  PP->addPPCallbacks(std::make_unique<UnrollLoopsPPCallbacks>(*this, SM));
+}
+
 void UnrollLoopsCheck::registerMatchers(MatchFinder *Finder) {
   const auto ANYLOOP = anyOf(forStmt(), whileStmt(), doStmt());
+  // Only the outermost loop of each nest is matched; the nest is then walked
+  // once to find its inner loops.
   Finder->addMatcher(stmt(
             allOf(
               ANYLOOP,  // Match all loop types,
-              unless(hasDescendant(forStmt())),
-              unless(hasDescendant(whileStmt())),
-              unless(hasDescendant(doStmt())))).bind("loop"), this);
+              unless(hasAncestor(stmt(ANYLOOP))))).bind("loop"), this);
 }
 
 void UnrollLoopsCheck::check(const MatchFinder::MatchResult &Result) {
   const Stmt *MatchedLoop = Result.Nodes.getNodeAs<Stmt>("loop");
-  const ASTContext *Context = Result.Context;
-  UnrollType unroll = unrollType(MatchedLoop, Result.Context);
-  if (unroll == NotUnrolled) {
-    diag(MatchedLoop->getBeginLoc(), "The performance of the kernel could be improved by unrolling this loop with a #pragma unroll directive");
+  LoopNest nest;
+  nest.Loop = MatchedLoop;
+  collectInnerLoops(getLoopBody(MatchedLoop), nest.InnerLoops);
+  checkLoopNest(nest, Result.Context);
+}
+
+bool UnrollLoopsCheck::isLoop(const Stmt *Statement) {
+  return isa<ForStmt>(Statement) || isa<WhileStmt>(Statement) || isa<DoStmt>(Statement);
+}
+
+const Stmt* UnrollLoopsCheck::getLoopBody(const Stmt *Statement) {
+  if (const auto *forStmt = dyn_cast<ForStmt>(Statement)) {
+    return forStmt->getBody();
+  }
+  if (const auto *whileStmt = dyn_cast<WhileStmt>(Statement)) {
+    return whileStmt->getBody();
+  }
+  if (const auto *doStmt = dyn_cast<DoStmt>(Statement)) {
+    return doStmt->getBody();
+  }
+  return nullptr;
+}
+
+void UnrollLoopsCheck::collectInnerLoops(const Stmt *Statement, std::vector<LoopNest> &InnerLoops) {
+  if (!Statement) {
+    return;
+  }
+  if (isLoop(Statement)) {
+    LoopNest inner;
+    inner.Loop = Statement;
+    collectInnerLoops(getLoopBody(Statement), inner.InnerLoops);
+    InnerLoops.push_back(std::move(inner));
+    return;
+  }
+  for (const Stmt *child : Statement->children()) {
+    collectInnerLoops(child, InnerLoops);
+  }
+}
+
+llvm::Optional<uint64_t> UnrollLoopsCheck::getNestIterations(const LoopNest &Nest, ASTContext *Context) {
+  const auto tripCount = utils::getTripCount(Nest.Loop, *Context);
+  if (!tripCount) {
+    return llvm::None;
+  }
+  // Sibling inner loops run one after the other, nested ones multiply.
+  uint64_t innerIterations = Nest.InnerLoops.empty() ? 1 : 0;
+  for (const LoopNest &inner : Nest.InnerLoops) {
+    const auto iterations = getNestIterations(inner, Context);
+    if (!iterations) {
+      return llvm::None;
+    }
+    innerIterations = llvm::SaturatingAdd(innerIterations, *iterations);
+  }
+  return llvm::SaturatingMultiply(*tripCount, innerIterations);
+}
+
+void UnrollLoopsCheck::checkLoopNest(const LoopNest &Nest, ASTContext *Context) {
+  const UnrollType unroll = unrollType(Nest.Loop, Context);
+  const bool pipelineTuned = checkLoopPragmas(Nest, unroll, Context);
+  if (Nest.InnerLoops.empty()) {
+    // A loop whose pipeline is explicitly tuned is not meant to be unrolled.
+    if (!(pipelineTuned && unroll == NotUnrolled)) {
+      checkInnermostLoop(Nest.Loop, Context);
+    }
+    return;
+  }
+  for (const LoopNest &inner : Nest.InnerLoops) {
+    checkLoopNest(inner, Context);
+  }
+
+  // Outer loops are pipelined by default. Unrolling them replicates all of
+  // their inner loops.
+  if (unroll == FullyUnrolled) {
+    if (!hasKnownBounds(Nest.Loop, Context)) {
+      diag(Nest.Loop->getBeginLoc(), "Full unrolling was requested, but loop bounds are not known. To partially unroll this loop, use the #pragma unroll <num> directive");
+      return;
+    }
+    const auto iterations = getNestIterations(Nest, Context);
+    if (iterations && *iterations > max_loop_iterations) {
+      diag(Nest.Loop->getBeginLoc(), "Fully unrolling this loop nest replicates its innermost body %0 times, which likely exceeds the available area. Consider pipelining this loop instead, and unrolling only its inner loops") << static_cast<unsigned>(std::min<uint64_t>(*iterations, std::numeric_limits<unsigned>::max()));
+    }
     return;
   }
   if (unroll == PartiallyUnrolled) {
+    for (const LoopNest &inner : Nest.InnerLoops) {
+      if (unrollType(inner.Loop, Context) != FullyUnrolled) {
+        diag(Nest.Loop->getBeginLoc(), "Unrolling this loop replicates the pipelines of its inner loops, which are not fully unrolled. Consider pipelining this loop instead, and unrolling its inner loops");
+        return;
+      }
+    }
+  }
+}
+
+void UnrollLoopsCheck::checkInnermostLoop(const Stmt *MatchedLoop, ASTContext *Context) {
+  UnrollType unroll = unrollType(MatchedLoop, Context);
+  if (unroll == NotUnrolled) {
+    unsigned operations = 0;
+    const auto tripCount = utils::getTripCount(MatchedLoop, *Context);
+    const uint64_t factor = tripCount ? recommendedUnrollFactor(MatchedLoop, *tripCount, operations) : 1;
+    {
+      auto diagnostic = diag(MatchedLoop->getBeginLoc(), "The performance of the kernel could be improved by unrolling this loop with a #pragma unroll directive");
+      const SourceLocation loopLoc = MatchedLoop->getBeginLoc();
+      // The directive goes on a line of its own, which is only possible if
+      // the loop starts its line.
+      if (factor > 1 && utils::getStartOfLoopLines(MatchedLoop, Context->getSourceManager()).isValid()) {
+        std::string pragma = "#pragma unroll";
+        if (factor != *tripCount) {
+          pragma += " " + std::to_string(factor);
+        }
+        pragma += "\n";
+        pragma += Lexer::getIndentationForLine(loopLoc, Context->getSourceManager());
+        diagnostic << FixItHint::CreateInsertion(loopLoc, pragma);
+      }
+    }
+    if (factor > 1) {
+      diag(MatchedLoop->getBeginLoc(), "unrolling this loop by a factor of %0 replicates %1 operations", DiagnosticIDs::Note) << static_cast<unsigned>(factor) << static_cast<unsigned>(factor * operations);
+    }
+    return;
+  }
+  if (unroll == PartiallyUnrolled || unroll == NoUnroll) {
     return;
   }
   if (unroll == FullyUnrolled) {
     if (hasKnownBounds(MatchedLoop, Context)) {
       if (hasLargeNumIterations(MatchedLoop, Context)) {
-        diag(MatchedLoop->getBeginLoc(), "This loop likely has a large number of iterations and thus cannot be fully unrolled. To partially unroll this loop, use the #pragma unroll <num> directive");
+        unsigned operations = 0;
+        const auto tripCount = utils::getTripCount(MatchedLoop, *Context);
+        const uint64_t factor = tripCount ? recommendedUnrollFactor(MatchedLoop, *tripCount, operations) : 1;
+        {
+          auto diagnostic = diag(MatchedLoop->getBeginLoc(), "This loop likely has a large number of iterations and thus cannot be fully unrolled. To partially unroll this loop, use the #pragma unroll <num> directive");
+          const LoopHintAttr *hint = getUnrollHint(MatchedLoop, Context);
+          if (factor > 1 && hint && !hint->getLocation().isMacroID()) {
+            if (hint->getSemanticSpelling() == LoopHintAttr::Pragma_unroll) {
+              // Turn "#pragma unroll" into "#pragma unroll <factor>".
+              const SourceLocation nameEnd = Lexer::getLocForEndOfToken(hint->getLocation(), 0, Context->getSourceManager(), Context->getLangOpts());
+              diagnostic << FixItHint::CreateInsertion(nameEnd, " " + std::to_string(factor));
+            } else {
+              // Turn "#pragma clang loop unroll(full)" into
+              // "#pragma clang loop unroll_count(<factor>)".
+              const CharSourceRange option = getUnrollOptionRange(hint->getLocation(), Context);
+              if (option.isValid()) {
+                diagnostic << FixItHint::CreateReplacement(option, "unroll_count(" + std::to_string(factor) + ")");
+              }
+            }
+          }
+        }
+        if (factor > 1) {
+          diag(MatchedLoop->getBeginLoc(), "unrolling this loop by a factor of %0 replicates %1 operations", DiagnosticIDs::Note) << static_cast<unsigned>(factor) << static_cast<unsigned>(factor * operations);
+        }
         return;
       }
       return;
@@ -49,106 +236,267 @@ void UnrollLoopsCheck::check(const MatchFinder::MatchResult &Result) {
   }
 }
 
-enum UnrollLoopsCheck::UnrollType UnrollLoopsCheck::unrollType(const Stmt *Statement, ASTContext *Context) {
-  const auto parents = Context->getParents(*Statement);
-  for (size_t i = 0; i < parents.size(); ++i) {
-    const auto &parent = parents[i];
-    if (parent.getNodeKind().asStringRef().equals("AttributedStmt")) {
-      const AttributedStmt *parentStmt = parent.get<AttributedStmt>();
-      for (size_t j = 0; j < parentStmt->getAttrs().size(); ++j) {
-        auto *attr = parentStmt->getAttrs()[j];
-        const LoopHintAttr *loopHintAttr;
-        if ((loopHintAttr = static_cast<const LoopHintAttr*>(attr))) {
-          if (loopHintAttr->getState() == LoopHintAttr::Numeric) {
-            return PartiallyUnrolled;
-          }
-          if (loopHintAttr->getState() == LoopHintAttr::Disable) {
-            return NotUnrolled;
-          }
-          if (loopHintAttr->getState() == LoopHintAttr::Full) {
-            return FullyUnrolled;
-          }
-          if (loopHintAttr->getState() == LoopHintAttr::Enable) {
-            return FullyUnrolled;
-          }
+CharSourceRange UnrollLoopsCheck::getUnrollOptionRange(SourceLocation PragmaName, ASTContext *Context) {
+  const SourceManager &sm = Context->getSourceManager();
+  const LangOptions &langOpts = Context->getLangOpts();
+  const unsigned line = sm.getSpellingLineNumber(PragmaName);
+  llvm::Optional<Token> token = Lexer::findNextToken(PragmaName, sm, langOpts);
+  while (token && !token->is(tok::eof) && sm.getSpellingLineNumber(token->getLocation()) == line) {
+    if (token->is(tok::raw_identifier) && token->getRawIdentifier() == "unroll") {
+      const SourceLocation begin = token->getLocation();
+      while (token && !token->is(tok::r_paren) && sm.getSpellingLineNumber(token->getLocation()) == line) {
+        token = Lexer::findNextToken(token->getLocation(), sm, langOpts);
+      }
+      if (!token || !token->is(tok::r_paren)) {
+        break;
+      }
+      return CharSourceRange::getTokenRange(begin, token->getLocation());
+    }
+    token = Lexer::findNextToken(token->getLocation(), sm, langOpts);
+  }
+  return CharSourceRange();
+}
+
+const LoopHintAttr* UnrollLoopsCheck::getUnrollHint(const Stmt *Statement, ASTContext *Context) {
+  for (const auto &parent : Context->getParents(*Statement)) {
+    if (const auto *parentStmt = parent.get<AttributedStmt>()) {
+      for (const Attr *attr : parentStmt->getAttrs()) {
+        const auto *loopHintAttr = dyn_cast<LoopHintAttr>(attr);
+        if (loopHintAttr && loopHintAttr->getOption() == LoopHintAttr::Unroll) {
+          return loopHintAttr;
         }
       }
     }
   }
-  return NotUnrolled;
+  return nullptr;
 }
 
-bool UnrollLoopsCheck::hasKnownBounds(const Stmt* Statement, const ASTContext* Context) {
-  const Expr *condExpr = getCondExpr(Statement);
-  if (!condExpr) {
-    return false; //diag(Statement->getBeginLoc(), statementClassName);
-  } 
-  if (std::string(condExpr->getStmtClassName()).compare("BinaryOperator") == 0) {
-    const BinaryOperator* binaryOp = static_cast<const BinaryOperator*>(condExpr);
-    const Expr* lhs = binaryOp->getLHS();
-    const Expr* rhs = binaryOp->getRHS();
-    if (lhs->isEvaluatable(*Context) == rhs->isEvaluatable(*Context)) {
-      return false;  // Both sides are value dependent or constant, so loop bounds are not known.
+unsigned UnrollLoopsCheck::countOperations(const Stmt *Statement) {
+  if (!Statement) {
+    return 0;
+  }
+  unsigned operations = 0;
+  if (const auto *binaryOp = dyn_cast<BinaryOperator>(Statement)) {
+    // Plain assignments and the comma operator are free; everything else,
+    // including compound assignments and comparisons, needs an operator.
+    if (binaryOp->getOpcode() != BO_Assign && binaryOp->getOpcode() != BO_Comma) {
+      operations++;
     }
-    return true;  // At least 1 side isn't value dependent, so we know the loop bounds.
+  } else if (const auto *unaryOp = dyn_cast<UnaryOperator>(Statement)) {
+    if (unaryOp->getOpcode() != UO_AddrOf && unaryOp->getOpcode() != UO_Plus &&
+        unaryOp->getOpcode() != UO_Extension) {
+      operations++;  // Includes dereferences, which are memory accesses.
+    }
+  } else if (isa<ArraySubscriptExpr>(Statement) || isa<CallExpr>(Statement) ||
+             isa<ConditionalOperator>(Statement)) {
+    operations++;
+  }
+  for (const Stmt *child : Statement->children()) {
+    operations += countOperations(child);
   }
-  return false;  // If it's not a binary operator, we don't know the loop bounds.
+  return operations;
 }
 
-const Expr* UnrollLoopsCheck::getCondExpr(const Stmt* Statement) {
-  const Expr *condExpr;
-  std::string statementClassName = Statement->getStmtClassName();
-  if (statementClassName.compare("ForStmt") == 0) {
-    const ForStmt *forStmt = static_cast<const ForStmt*>(Statement);
-    condExpr = forStmt->getCond();
+uint64_t UnrollLoopsCheck::recommendedUnrollFactor(const Stmt *Statement, uint64_t TripCount, unsigned &Operations) {
+  Operations = std::max(countOperations(getLoopBody(Statement)), 1U);
+  const uint64_t maxFactor = std::min<uint64_t>(
+      {TripCount, max_loop_iterations, max_unrolled_operations / Operations});
+  for (uint64_t factor = maxFactor; factor > 1; --factor) {
+    if (TripCount % factor == 0) {
+      return factor;
+    }
   }
-  if (statementClassName.compare("WhileStmt") == 0) {
-    const WhileStmt *whileStmt = static_cast<const WhileStmt*>(Statement);
-    condExpr = whileStmt->getCond();
+  return 1;
+}
+
+void UnrollLoopsCheck::addLoopPragma(SourceLocation Loc, StringRef Name, StringRef Argument, const SourceManager &SM) {
+  const std::pair<FileID, unsigned> decomposed = SM.getDecomposedLoc(Loc);
+  const unsigned line = SM.getLineNumber(decomposed.first, decomposed.second);
+  LoopPragma pragma = {Loc, Name.str(), Argument.str()};
+  Pragmas[{decomposed.first.getHashValue(), line}] = std::move(pragma);
+}
+
+std::vector<UnrollLoopsCheck::LoopPragma> UnrollLoopsCheck::getLoopPragmas(const Stmt *Statement, ASTContext *Context) {
+  std::vector<LoopPragma> result;
+  // Pragmas that clang turns into loop hint attributes.
+  for (const auto &parent : Context->getParents(*Statement)) {
+    if (const auto *parentStmt = parent.get<AttributedStmt>()) {
+      for (const Attr *attr : parentStmt->getAttrs()) {
+        const auto *loopHintAttr = dyn_cast<LoopHintAttr>(attr);
+        if (!loopHintAttr) {
+          continue;
+        }
+        if (loopHintAttr->getOption() == LoopHintAttr::PipelineInitiationInterval) {
+          result.push_back({loopHintAttr->getLocation(), "clang loop pipeline_initiation_interval", ""});
+        } else if (loopHintAttr->getOption() == LoopHintAttr::PipelineDisabled) {
+          result.push_back({loopHintAttr->getLocation(), "clang loop pipeline", ""});
+        }
+      }
+    }
   }
-  if (statementClassName.compare("DoStmt") == 0) {
-    const DoStmt *doStmt = static_cast<const DoStmt*>(Statement);
-    condExpr = doStmt->getCond();
+  // Pragmas that clang does not know about, on the lines directly preceding
+  // the loop.
+  const SourceManager &SM = Context->getSourceManager();
+  const SourceLocation loopLoc = SM.getExpansionLoc(Statement->getBeginLoc());
+  const std::pair<FileID, unsigned> decomposed = SM.getDecomposedLoc(loopLoc);
+  unsigned line = SM.getLineNumber(decomposed.first, decomposed.second);
+  while (--line > 0) {
+    const auto found = Pragmas.find({decomposed.first.getHashValue(), line});
+    if (found == Pragmas.end()) {
+      break;
+    }
+    result.push_back(found->second);
+  }
+  return result;
+}
+
+unsigned UnrollLoopsCheck::getNestDepth(const LoopNest &Nest) {
+  unsigned innerDepth = 0;
+  for (const LoopNest &inner : Nest.InnerLoops) {
+    innerDepth = std::max(innerDepth, getNestDepth(inner));
   }
-  return condExpr;
+  return innerDepth + 1;
 }
 
-bool UnrollLoopsCheck::hasLargeNumIterations(const Stmt* Statement, const ASTContext* Context) {
-  const Expr *condExpr = getCondExpr(Statement);
-  if (!condExpr) {
-    return false;
-  } 
-  if (std::string(condExpr->getStmtClassName()).compare("BinaryOperator") == 0) {
-    const BinaryOperator* binaryOp = static_cast<const BinaryOperator*>(condExpr);
-    const Expr* lhs = binaryOp->getLHS();
-    const Expr* rhs = binaryOp->getRHS();
-    Expr::EvalResult result;
-    if (lhs->isEvaluatable(*Context) && !(rhs->isEvaluatable(*Context))) {
-      return exprHasLargeNumIterations(lhs, Context);
+bool UnrollLoopsCheck::checkLoopPragmas(const LoopNest &Nest, UnrollType Unroll, ASTContext *Context) {
+  bool pipelineTuned = false;
+  for (const LoopPragma &pragma : getLoopPragmas(Nest.Loop, Context)) {
+    const StringRef name = pragma.Name;
+    const bool isPipelinePragma = name == "ii" || name == "max_concurrency" ||
+        name == "speculated_iterations" || name.startswith("clang loop pipeline");
+    if (!isPipelinePragma && name != "ivdep" && name != "loop_coalesce") {
+      continue;
+    }
+    pipelineTuned |= isPipelinePragma;
+    if (Unroll == FullyUnrolled) {
+      diag(pragma.Loc, "#pragma %0 has no effect on a fully unrolled loop, which is not pipelined") << name;
+      continue;
+    }
+    if (name != "loop_coalesce") {
+      continue;
+    }
+    if (Nest.InnerLoops.empty()) {
+      diag(pragma.Loc, "#pragma loop_coalesce has no effect on a loop that does not contain nested loops");
+      continue;
     }
-    if (rhs->isEvaluatable(*Context) && !(lhs->isEvaluatable(*Context))) {
-      return exprHasLargeNumIterations(rhs, Context);
+    unsigned levels = 0;
+    const unsigned depth = getNestDepth(Nest);
+    if (!StringRef(pragma.Argument).getAsInteger(0, levels) && levels > depth) {
+      diag(pragma.Loc, "#pragma loop_coalesce %0 coalesces more loops than the %1 this loop nest contains") << levels << depth;
     }
   }
-  return false;  // Cannot check number of iteration, return false to be safe
+  return pipelineTuned;
 }
 
-bool UnrollLoopsCheck::exprHasLargeNumIterations(const Expr* expr, const ASTContext* Context) {
-  Expr::EvalResult result;
-  if (expr->EvaluateAsRValue(result, *Context)) {
-    if (!(result.Val.isInt())) {
-      return false;  // Cannot check number of iterations, return false to be safe
+enum UnrollLoopsCheck::UnrollType UnrollLoopsCheck::unrollType(const Stmt *Statement, ASTContext *Context) {
+  for (const auto &parent : Context->getParents(*Statement)) {
+    const auto *parentStmt = parent.get<AttributedStmt>();
+    if (!parentStmt) {
+      continue;
+    }
+    for (const Attr *attr : parentStmt->getAttrs()) {
+      const auto *loopHintAttr = dyn_cast<LoopHintAttr>(attr);
+      if (!loopHintAttr) {
+        continue;
+      }
+      switch (loopHintAttr->getOption()) {
+      case LoopHintAttr::Unroll:
+        // #pragma unroll, #pragma nounroll or #pragma clang loop unroll(...)
+        if (loopHintAttr->getState() == LoopHintAttr::Disable) {
+          return NoUnroll;
+        }
+        return FullyUnrolled;
+      case LoopHintAttr::UnrollCount: {
+        // #pragma unroll <num> or #pragma clang loop unroll_count(<num>)
+        const auto factor = utils::evaluateInteger(loopHintAttr->getValue(), *Context);
+        if (factor && *factor == 1) {
+          return NoUnroll;
+        }
+        return PartiallyUnrolled;
+      }
+      default:
+        // Vectorization, interleaving and pipelining hints do not unroll.
+        break;
+      }
     }
-    if (result.Val.getInt() > max_loop_iterations) {
-      return true;  // Assumes values go from 0 to Val in increments of 1
+  }
+  return NotUnrolled;
+}
+
+llvm::Optional<uint64_t> UnrollLoopsCheck::getUnrollFactor(const Stmt *Statement, ASTContext *Context) {
+  switch (unrollType(Statement, Context)) {
+  case FullyUnrolled:
+    return utils::getTripCount(Statement, *Context);
+  case PartiallyUnrolled: {
+    for (const auto &parent : Context->getParents(*Statement)) {
+      if (const auto *parentStmt = parent.get<AttributedStmt>()) {
+        for (const Attr *attr : parentStmt->getAttrs()) {
+          const auto *loopHintAttr = dyn_cast<LoopHintAttr>(attr);
+          if (loopHintAttr && loopHintAttr->getOption() == LoopHintAttr::UnrollCount) {
+            const auto factor = utils::evaluateInteger(loopHintAttr->getValue(), *Context);
+            if (factor && *factor > 1) {
+              return static_cast<uint64_t>(*factor);
+            }
+          }
+        }
+      }
     }
-    return false;  // Number of iterations likely less than max_loop_iterations
+    return 1;
+  }
+  default:
+    return 1;
+  }
+}
+
+bool UnrollLoopsCheck::hasKnownBounds(const Stmt* Statement, ASTContext* Context) {
+  if (const auto Loop = utils::getInductionLoop(Statement, *Context)) {
+    return utils::getTripCount(*Loop).hasValue();  // Unknown if the loop does not terminate.
+  }
+  const auto *binaryOp = dyn_cast_or_null<BinaryOperator>(getCondExpr(Statement));
+  if (!binaryOp) {
+    return false;  // If it's not a binary operator, we don't know the loop bounds.
+  }
+  const bool lhsIsConstant = utils::evaluateInteger(binaryOp->getLHS(), *Context).hasValue();
+  const bool rhsIsConstant = utils::evaluateInteger(binaryOp->getRHS(), *Context).hasValue();
+  // If both sides are value dependent or constant, the loop bounds are not known.
+  // Otherwise, the constant side is used as an estimate of the bound.
+  return lhsIsConstant != rhsIsConstant;
+}
+
+const Expr* UnrollLoopsCheck::getCondExpr(const Stmt* Statement) {
+  const Expr *condExpr = nullptr;
+  if (const auto *forStmt = dyn_cast<ForStmt>(Statement)) {
+    condExpr = forStmt->getCond();
+  } else if (const auto *whileStmt = dyn_cast<WhileStmt>(Statement)) {
+    condExpr = whileStmt->getCond();
+  } else if (const auto *doStmt = dyn_cast<DoStmt>(Statement)) {
+    condExpr = doStmt->getCond();
+  }
+  return condExpr ? condExpr->IgnoreParenImpCasts() : nullptr;
+}
+
+bool UnrollLoopsCheck::hasLargeNumIterations(const Stmt* Statement, ASTContext* Context) {
+  if (const auto tripCount = utils::getTripCount(Statement, *Context)) {
+    return *tripCount > max_loop_iterations;
+  }
+  const auto *binaryOp = dyn_cast_or_null<BinaryOperator>(getCondExpr(Statement));
+  if (!binaryOp) {
+    return false;  // Cannot check number of iterations, return false to be safe
+  }
+  const auto lhs = utils::evaluateInteger(binaryOp->getLHS(), *Context);
+  const auto rhs = utils::evaluateInteger(binaryOp->getRHS(), *Context);
+  if (lhs.hasValue() == rhs.hasValue()) {
+    return false;  // Cannot check number of iterations, return false to be safe
   }
-  return false;  // Cannot evaluate as an r-value, so cannot check number of iterations
+  // The induction variable could not be recognized, so assume that it goes
+  // from 0 to the constant bound in increments of 1.
+  const int64_t bound = lhs.hasValue() ? *lhs : *rhs;
+  return bound > 0 && static_cast<uint64_t>(bound) > max_loop_iterations;
 }
 
 void UnrollLoopsCheck::storeOptions(ClangTidyOptions::OptionMap &Opts) {
   Options.store(Opts, "max_loop_iterations", max_loop_iterations);
+  Options.store(Opts, "max_unrolled_operations", max_unrolled_operations);
 }
 
 } // namespace FPGA
@@ -10,6 +10,9 @@
 #define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_FPGA_UNROLLLOOPSCHECK_H
 
 #include "../ClangTidy.h"
+#include <map>
+#include <string>
+#include <vector>
 
 namespace clang {
 namespace tidy {
@@ -20,42 +23,104 @@ namespace FPGA {
 /// Also attempts to finds for, while and do..while loops that have been fully 
 /// unrolled, but either have unknown bounds or a large number of iterations.
 /// The compiler will not unroll these loops, so partial unrolling is
-/// recommended in these cases.
+/// recommended in these cases. Outer loops of a loop nest that are unrolled
+/// in a way that replicates too much of the nest should be pipelined instead.
 ///
 /// For the user-facing documentation see:
 /// http://clang.llvm.org/extra/clang-tidy/checks/FPGA-unroll-loops.html
 class UnrollLoopsCheck : public ClangTidyCheck {
 const unsigned max_loop_iterations;
+const unsigned max_unrolled_operations;
 
 public:
   UnrollLoopsCheck(StringRef Name, ClangTidyContext *Context)
       : ClangTidyCheck(Name, Context),
-    max_loop_iterations(Options.get("max_loop_iterations", 100U)) {}
+    max_loop_iterations(Options.get("max_loop_iterations", 100U)),
+    max_unrolled_operations(Options.get("max_unrolled_operations", 128U)) {}
+  void registerPPCallbacks(const SourceManager &SM, Preprocessor *PP,
+                           Preprocessor *ModuleExpanderPP) override;
   void registerMatchers(ast_matchers::MatchFinder *Finder) override;
   void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
-private:
+  /// Records a #pragma directive, which may apply to the loop that follows it.
+  void addLoopPragma(SourceLocation Loc, StringRef Name, StringRef Argument,
+                     const SourceManager &SM);
   /// The kind of unrolling, if any, applied to a given loop
   enum UnrollType { 
     NotUnrolled, // This loop has no #pragma unroll directive associated with it
     FullyUnrolled, // This loop has a #pragma unroll directive associated with it
-    PartiallyUnrolled // This loop has a #pragma unroll <num> directive associated with it
+    PartiallyUnrolled, // This loop has a #pragma unroll <num> directive associated with it
+    NoUnroll // This loop has a #pragma nounroll or #pragma unroll 1 directive associated with it
   };
-  /// Returns true if the given loop statement has a large number of iterations,
-  /// as determined by the integer value in the loop's condition expression, 
-  /// if one exists.
-  bool hasLargeNumIterations(const Stmt* Statement, const ASTContext* Context);
-  /// Checks one hand side of the binary operator to ascertain if the upper
-  /// bound on the number of loops is greater than max_loop_iterations or not.
-  /// If the expression is not evaluatable or not an integer, returns false.
-  bool exprHasLargeNumIterations(const Expr* expr, const ASTContext* Context);
   /// Returns the type of unrolling, if any, associated with the given 
   /// statement.
-  enum UnrollType unrollType(const Stmt* Statement, ASTContext *Context);
+  static enum UnrollType unrollType(const Stmt* Statement, ASTContext *Context);
+  /// Returns the number of copies of the body of the given loop statement
+  /// that its #pragma unroll directive creates: the factor of a partially
+  /// unrolled loop, the trip count of a fully unrolled loop, or 1 if the loop
+  /// is not unrolled. Returns None for a fully unrolled loop whose trip count
+  /// is not known.
+  static llvm::Optional<uint64_t> getUnrollFactor(const Stmt* Statement, ASTContext *Context);
+private:
+  /// A #pragma directive preceding a loop, such as #pragma ii <num>.
+  struct LoopPragma {
+    SourceLocation Loc;
+    std::string Name;
+    std::string Argument;
+  };
+  /// The #pragma directives of the translation unit, by file and line.
+  std::map<std::pair<unsigned, unsigned>, LoopPragma> Pragmas;
+  /// A loop and the loops directly nested in its body.
+  struct LoopNest {
+    const Stmt *Loop = nullptr;
+    std::vector<LoopNest> InnerLoops;
+  };
+  /// Returns true if the statement is a for, while or do..while loop.
+  static bool isLoop(const Stmt* Statement);
+  /// Returns the body of the given loop statement.
+  static const Stmt* getLoopBody(const Stmt* Statement);
+  /// Adds the outermost loops within the given statement to InnerLoops.
+  void collectInnerLoops(const Stmt* Statement, std::vector<LoopNest> &InnerLoops);
+  /// Returns the number of times the innermost bodies of the loop nest are
+  /// executed, or None if a trip count is not known.
+  llvm::Optional<uint64_t> getNestIterations(const LoopNest &Nest, ASTContext* Context);
+  /// Returns the loop pragmas applied to the given loop statement: the
+  /// pipelining loop hints, and the directives on the lines directly preceding
+  /// the loop.
+  std::vector<LoopPragma> getLoopPragmas(const Stmt* Statement, ASTContext* Context);
+  /// Returns the number of loops on the deepest path of the loop nest.
+  static unsigned getNestDepth(const LoopNest &Nest);
+  /// Reports the loop pragmas of the nest's outermost loop that have no effect
+  /// given how it is unrolled. Returns true if the loop has a pragma that
+  /// controls its pipeline (ii, max_concurrency or speculated_iterations).
+  bool checkLoopPragmas(const LoopNest &Nest, UnrollType Unroll, ASTContext* Context);
+  /// Checks the unrolling of every loop in the nest.
+  void checkLoopNest(const LoopNest &Nest, ASTContext* Context);
+  /// Checks the unrolling of a loop that does not contain other loops.
+  void checkInnermostLoop(const Stmt* Statement, ASTContext* Context);
+  /// Returns true if the given loop statement has a large number of iterations.
+  /// The exact trip count is used if the loop's induction variable can be
+  /// recognized; otherwise, the integer value in the loop's condition
+  /// expression, if one exists, is used as an estimate.
+  bool hasLargeNumIterations(const Stmt* Statement, ASTContext* Context);
   /// Returns the condition expression within a given for statement. If there is none,
   /// or if the Statement is not a loop, then returns a NULL pointer.
   const Expr* getCondExpr(const Stmt* Statement);
+  /// Returns the #pragma unroll attribute attached to the given loop statement,
+  /// if any.
+  const LoopHintAttr* getUnrollHint(const Stmt* Statement, ASTContext* Context);
+  /// Returns the range of the unroll(...) option of the #pragma clang loop
+  /// directive whose name is at the given location, or an invalid range.
+  static CharSourceRange getUnrollOptionRange(SourceLocation PragmaName, ASTContext* Context);
+  /// Returns the number of arithmetic, logic, memory and call operations in
+  /// the given statement, used as an estimate of the area of one iteration.
+  unsigned countOperations(const Stmt* Statement);
+  /// Returns the largest divisor of TripCount, not exceeding
+  /// max_loop_iterations, by which the loop can be unrolled without replicating
+  /// more than max_unrolled_operations operations. Sets Operations to the
+  /// number of operations in one iteration of the loop body.
+  uint64_t recommendedUnrollFactor(const Stmt* Statement, uint64_t TripCount, unsigned &Operations);
   /// Returns True if the loop statement has known bounds
-  bool hasKnownBounds(const Stmt* Statement, const ASTContext* Context);
+  bool hasKnownBounds(const Stmt* Statement, ASTContext* Context);
   void storeOptions(ClangTidyOptions::OptionMap &Opts);
 };
 
@@ -0,0 +1,207 @@
+//===--- WorkGroupSizeCheck.cpp - clang-tidy ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "WorkGroupSizeCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/KernelClassifier.h"
+#include "../utils/LexerUtils.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace FPGA {
+
+namespace {
+
+/// The smallest __local array dimension indexed by the local ID of one
+/// dimension of the NDRange.
+struct DimensionBound {
+  uint64_t Size = 0;
+  const ArraySubscriptExpr *Access = nullptr;
+  const VarDecl *Array = nullptr;
+};
+
+/// Infers the work-group size from the subscripts of __local arrays.
+class WorkGroupShape {
+public:
+  WorkGroupShape(const FunctionDecl *Kernel, const ASTContext &Context)
+      : Context(Context) {
+    utils::collectModifiedVars(Kernel->getBody(), Modified);
+  }
+
+  void collect(const Stmt *S);
+
+  DimensionBound Bounds[3];
+
+private:
+  /// Returns the dimension of the NDRange whose local ID \p E is, looking
+  /// through variables that are only given a value by their initializer, or
+  /// -1.
+  int getLocalIDDimension(const Expr *E, unsigned Depth = 0) const;
+
+  void addSubscripts(const ArraySubscriptExpr *Access, const Expr *Base,
+                     llvm::ArrayRef<const Expr *> Indices);
+
+  const ASTContext &Context;
+  llvm::SmallPtrSet<const VarDecl *, 16> Modified;
+};
+
+int WorkGroupShape::getLocalIDDimension(const Expr *E, unsigned Depth) const {
+  E = E->IgnoreParenImpCasts();
+  if (const auto *Call = dyn_cast<CallExpr>(E)) {
+    const FunctionDecl *Callee = Call->getDirectCallee();
+    if (!Callee || !Callee->getIdentifier() ||
+        Callee->getName() != "get_local_id" || Call->getNumArgs() != 1)
+      return -1;
+    const llvm::Optional<int64_t> Dimension =
+        utils::evaluateInteger(Call->getArg(0), Context);
+    return Dimension && *Dimension >= 0 && *Dimension < 3 ? *Dimension : -1;
+  }
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E))
+    if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+      if (Var->hasLocalStorage() && !isa<ParmVarDecl>(Var) &&
+          Var->getInit() && !Modified.count(Var) && Depth < 8)
+        return getLocalIDDimension(Var->getInit(), Depth + 1);
+  return -1;
+}
+
+void WorkGroupShape::addSubscripts(const ArraySubscriptExpr *Access,
+                                   const Expr *Base,
+                                   llvm::ArrayRef<const Expr *> Indices) {
+  const auto *Ref = dyn_cast<DeclRefExpr>(Base->IgnoreParenImpCasts());
+  const auto *Array = Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+  if (!Array || !Array->getType()->isConstantArrayType() ||
+      Context.getBaseElementType(Array->getType()).getAddressSpace() !=
+          LangAS::opencl_local)
+    return;
+
+  QualType Type = Array->getType();
+  for (const Expr *Index : Indices) {
+    const ConstantArrayType *ArrayType = Context.getAsConstantArrayType(Type);
+    if (!ArrayType)
+      return;
+    Type = ArrayType->getElementType();
+    const int Dimension = getLocalIDDimension(Index);
+    if (Dimension < 0)
+      continue;
+    const uint64_t Size = ArrayType->getSize().getZExtValue();
+    DimensionBound &Bound = Bounds[Dimension];
+    if (!Bound.Access || Size < Bound.Size) {
+      Bound.Size = Size;
+      Bound.Access = Access;
+      Bound.Array = Array;
+    }
+  }
+}
+
+void WorkGroupShape::collect(const Stmt *S) {
+  if (!S)
+    return;
+  const auto *Access = dyn_cast<ArraySubscriptExpr>(S);
+  if (!Access) {
+    for (const Stmt *Child : S->children())
+      collect(Child);
+    return;
+  }
+
+  // Gather the subscripts of a multi-dimensional access such as
+  // ``Tile[y][x]``, outermost dimension first.
+  llvm::SmallVector<const Expr *, 3> Indices;
+  const Expr *Base = Access;
+  while (const auto *Subscript =
+             dyn_cast<ArraySubscriptExpr>(Base->IgnoreParenImpCasts())) {
+    Indices.insert(Indices.begin(), Subscript->getIdx());
+    Base = Subscript->getBase();
+  }
+  addSubscripts(Access, Base, Indices);
+  for (const Expr *Index : Indices)
+    collect(Index);
+  collect(Base);
+}
+
+} // namespace
+
+void WorkGroupSizeCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel),
+                   unless(hasAttr(attr::Kind::ReqdWorkGroupSize)))
+          .bind("kernel"),
+      this);
+}
+
+void WorkGroupSizeCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+  utils::KernelClassifier &Classifier =
+      getTranslationUnitAnalysis<utils::KernelClassifier>();
+  const utils::KernelClassifier::KernelInfo &Info =
+      Classifier.classify(Kernel, Context);
+  if (Info.Model != utils::KernelClassifier::NDRange ||
+      utils::lexer::hasLeadingAttribute(Kernel, "max_work_group_size",
+                                        *Result.SourceManager, getLangOpts()))
+    return;
+
+  // The dimensions in which the work-items are told apart need a size; the
+  // others are left at 1.
+  bool UsedDimensions[3] = {false, false, false};
+  for (const CallExpr *Call : Info.IDCalls) {
+    const StringRef Name = Call->getDirectCallee()->getName();
+    if (Name == "get_group_id" || Name == "get_global_offset")
+      continue;
+    if (Call->getNumArgs() != 1)
+      return;
+    const llvm::Optional<int64_t> Dimension =
+        utils::evaluateInteger(Call->getArg(0), Context);
+    if (!Dimension || *Dimension < 0 || *Dimension >= 3)
+      return;
+    UsedDimensions[*Dimension] = true;
+  }
+
+  WorkGroupShape Shape(Kernel, Context);
+  Shape.collect(Kernel->getBody());
+  uint64_t Sizes[3] = {1, 1, 1};
+  bool Inferred = false;
+  for (unsigned Dimension = 0; Dimension != 3; ++Dimension) {
+    if (!UsedDimensions[Dimension])
+      continue;
+    if (!Shape.Bounds[Dimension].Access)
+      return;
+    Sizes[Dimension] = Shape.Bounds[Dimension].Size;
+    Inferred = true;
+  }
+  if (!Inferred)
+    return;
+
+  const std::string Attribute =
+      ("__attribute__((reqd_work_group_size(" + llvm::Twine(Sizes[0]) + ", " +
+       llvm::Twine(Sizes[1]) + ", " + llvm::Twine(Sizes[2]) + ")))\n")
+          .str();
+  diag(Kernel->getLocation(),
+       "kernel %0 has no reqd_work_group_size attribute, so its hardware is "
+       "sized for the largest work-group; the __local arrays it indexes with "
+       "get_local_id suggest a work-group size of (%1, %2, %3)")
+      << Kernel << static_cast<unsigned>(Sizes[0])
+      << static_cast<unsigned>(Sizes[1]) << static_cast<unsigned>(Sizes[2])
+      << FixItHint::CreateInsertion(Kernel->getBeginLoc(), Attribute);
+  for (unsigned Dimension = 0; Dimension != 3; ++Dimension)
+    if (UsedDimensions[Dimension])
+      diag(Shape.Bounds[Dimension].Access->getBeginLoc(),
+           "%0 is indexed by get_local_id(%1) in a dimension of size %2",
+           DiagnosticIDs::Note)
+          << Shape.Bounds[Dimension].Array << Dimension
+          << static_cast<unsigned>(Shape.Bounds[Dimension].Size);
+}
+
+} // namespace FPGA
+} // namespace tidy
+} // namespace clang
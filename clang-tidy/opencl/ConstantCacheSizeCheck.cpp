@@ -0,0 +1,217 @@
+//===--- ConstantCacheSizeCheck.cpp - clang-tidy --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ConstantCacheSizeCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LoopUtils.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <limits>
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace OpenCL {
+
+namespace {
+
+/// A __constant argument or program-scope variable read by a kernel.
+struct ConstantData {
+  const VarDecl *Var;
+  uint64_t Size;
+  /// The size is inferred from the accesses, and is only a lower bound.
+  bool IsLowerBound;
+};
+
+/// Returns the largest value that \p Index takes at \p Access: a constant,
+/// or the induction variable of an enclosing loop with constant bounds, plus
+/// or minus a constant.
+llvm::Optional<int64_t> getMaxIndex(const Expr *Index, const Expr *Access,
+                                    ASTContext &Context) {
+  if (llvm::Optional<int64_t> Value = utils::evaluateInteger(Index, Context))
+    return Value;
+  Index = Index->IgnoreParenImpCasts();
+
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(Index)) {
+    if (BinOp->getOpcode() != BO_Add && BinOp->getOpcode() != BO_Sub)
+      return llvm::None;
+    if (llvm::Optional<int64_t> Offset =
+            utils::evaluateInteger(BinOp->getRHS(), Context))
+      if (llvm::Optional<int64_t> Max =
+              getMaxIndex(BinOp->getLHS(), Access, Context))
+        return BinOp->getOpcode() == BO_Add ? *Max + *Offset : *Max - *Offset;
+    if (BinOp->getOpcode() == BO_Add)
+      if (llvm::Optional<int64_t> Offset =
+              utils::evaluateInteger(BinOp->getLHS(), Context))
+        if (llvm::Optional<int64_t> Max =
+                getMaxIndex(BinOp->getRHS(), Access, Context))
+          return *Max + *Offset;
+    return llvm::None;
+  }
+
+  const auto *Ref = dyn_cast<DeclRefExpr>(Index);
+  if (!Ref)
+    return llvm::None;
+  ast_type_traits::DynTypedNode Node =
+      ast_type_traits::DynTypedNode::create(*Access);
+  while (true) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() || Parents[0].get<FunctionDecl>())
+      return llvm::None;
+    Node = Parents[0];
+    const auto *Loop = Node.get<Stmt>();
+    if (!Loop || !utils::isLoop(Loop))
+      continue;
+    llvm::Optional<utils::InductionLoop> Induction =
+        utils::getInductionLoop(Loop, Context);
+    if (!Induction || Induction->Var != Ref->getDecl())
+      continue;
+    llvm::Optional<uint64_t> TripCount = utils::getTripCount(*Induction);
+    if (!TripCount || *TripCount == 0)
+      return llvm::None;
+    const int64_t Last =
+        Induction->Init +
+        Induction->Step * static_cast<int64_t>(*TripCount - 1);
+    return std::max(Induction->Init, Last);
+  }
+}
+
+/// Collects the program-scope __constant variables used within \p S and the
+/// functions it calls, in the order they are first used.
+void collectProgramConstants(
+    const Stmt *S, const ASTContext &Context,
+    llvm::SmallPtrSetImpl<const FunctionDecl *> &Visited,
+    llvm::SetVector<const VarDecl *> &Constants) {
+  if (!S)
+    return;
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(S)) {
+    if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+      if (Var->hasGlobalStorage() &&
+          Context.getBaseElementType(Var->getType()).getAddressSpace() ==
+              LangAS::opencl_constant)
+        Constants.insert(Var->getCanonicalDecl());
+  } else if (const auto *Call = dyn_cast<CallExpr>(S)) {
+    const FunctionDecl *Definition = nullptr;
+    if (const FunctionDecl *Callee = Call->getDirectCallee())
+      if (Callee->hasBody(Definition) && Visited.insert(Definition).second)
+        collectProgramConstants(Definition->getBody(), Context, Visited,
+                                Constants);
+  }
+  for (const Stmt *Child : S->children())
+    collectProgramConstants(Child, Context, Visited, Constants);
+}
+
+} // namespace
+
+void ConstantCacheSizeCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("kernel"),
+      this);
+}
+
+void ConstantCacheSizeCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+  llvm::SmallVector<ConstantData, 8> Data;
+  bool HasUnknownSize = false;
+
+  // The size of the buffer behind a __constant argument is only known on the
+  // host; the largest element the kernel reads gives a lower bound.
+  llvm::SmallVector<utils::MemoryAccess, 32> Accesses;
+  utils::collectMemoryAccesses(Kernel->getBody(), Accesses);
+  for (const ParmVarDecl *Param : Kernel->parameters()) {
+    const auto *Pointer = Param->getType()->getAs<PointerType>();
+    if (!Pointer ||
+        Pointer->getPointeeType().getAddressSpace() != LangAS::opencl_constant)
+      continue;
+    const QualType Element = Pointer->getPointeeType();
+    unsigned NumAccesses = 0;
+    llvm::Optional<int64_t> MaxIndex = -1;
+    for (const utils::MemoryAccess &Access : Accesses) {
+      if (Access.Base != Param || !MaxIndex)
+        continue;
+      ++NumAccesses;
+      llvm::Optional<int64_t> Index = 0;
+      if (Access.IsMultiDimensional)
+        Index = llvm::None;
+      else if (Access.Index)
+        Index = getMaxIndex(Access.Index, Access.Access, Context);
+      MaxIndex = Index ? std::max(*MaxIndex, *Index) : Index;
+    }
+    // The pointer escapes if it is used other than to read an element.
+    if (!MaxIndex || Element->isIncompleteType() ||
+        utils::countReferences(Kernel->getBody(), Param) != NumAccesses) {
+      HasUnknownSize = true;
+      continue;
+    }
+    if (*MaxIndex < 0)
+      continue;
+    Data.push_back({Param,
+                    llvm::SaturatingMultiply(
+                        static_cast<uint64_t>(*MaxIndex) + 1,
+                        static_cast<uint64_t>(
+                            Context.getTypeSizeInChars(Element).getQuantity())),
+                    true});
+  }
+
+  llvm::SmallPtrSet<const FunctionDecl *, 8> Visited;
+  llvm::SetVector<const VarDecl *> Constants;
+  collectProgramConstants(Kernel->getBody(), Context, Visited, Constants);
+  for (const VarDecl *Var : Constants) {
+    if (Var->getType()->isIncompleteType())
+      continue;
+    Data.push_back(
+        {Var,
+         static_cast<uint64_t>(
+             Context.getTypeSizeInChars(Var->getType()).getQuantity()),
+         false});
+  }
+
+  uint64_t Total = 0;
+  bool IsLowerBound = HasUnknownSize;
+  for (const ConstantData &Item : Data) {
+    Total = llvm::SaturatingAdd(Total, Item.Size);
+    IsLowerBound |= Item.IsLowerBound;
+  }
+  if (Total <= ConstantCacheSize)
+    return;
+
+  const auto Truncate = [](uint64_t Value) {
+    return static_cast<unsigned>(
+        std::min<uint64_t>(Value, std::numeric_limits<unsigned>::max()));
+  };
+  diag(Kernel->getLocation(),
+       "kernel %0 reads %select{|at least }1%2 bytes of __constant data, more "
+       "than the %3-byte constant cache holds; consider moving the largest "
+       "arrays to __local memory or to private ROMs")
+      << Kernel << IsLowerBound << Truncate(Total) << ConstantCacheSize;
+  std::stable_sort(Data.begin(), Data.end(),
+                   [](const ConstantData &LHS, const ConstantData &RHS) {
+                     return LHS.Size > RHS.Size;
+                   });
+  for (const ConstantData &Item : Data)
+    diag(Item.Var->getLocation(),
+         "%0 holds %select{|at least }1%2 bytes of __constant data",
+         DiagnosticIDs::Note)
+        << Item.Var << Item.IsLowerBound << Truncate(Item.Size);
+}
+
+void ConstantCacheSizeCheck::storeOptions(ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "ConstantCacheSize", ConstantCacheSize);
+}
+
+} // namespace OpenCL
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,45 @@
+//===--- ConstantCacheSizeCheck.h - clang-tidy ------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_CONSTANTCACHESIZECHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_CONSTANTCACHESIZECHECK_H
+
+#include "../ClangTidy.h"
+
+namespace clang {
+namespace tidy {
+namespace OpenCL {
+
+/// Totals the __constant data that each kernel reads, from its __constant
+/// pointer arguments and the program-scope __constant variables it and its
+/// callees use, and reports kernels whose data does not fit in the constant
+/// cache.
+///
+/// The size of an argument is taken from the largest index it is accessed
+/// with, when the index is a constant or the induction variable of a loop
+/// with constant bounds.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/opencl-constant-cache-size.html
+class ConstantCacheSizeCheck : public ClangTidyCheck {
+  const unsigned ConstantCacheSize;
+
+public:
+  ConstantCacheSizeCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context),
+        ConstantCacheSize(Options.get("ConstantCacheSize", 16384U)) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
+};
+
+} // namespace OpenCL
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_CONSTANTCACHESIZECHECK_H
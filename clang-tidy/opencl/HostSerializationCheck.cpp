@@ -0,0 +1,278 @@
+//===--- HostSerializationCheck.cpp - clang-tidy --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "HostSerializationCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/LoopUtils.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace OpenCL {
+
+namespace {
+
+/// The commands that take a blocking flag, and the index of the flag.
+const std::pair<StringRef, unsigned> BlockingCommands[] = {
+    {"clEnqueueReadBuffer", 2},      {"clEnqueueWriteBuffer", 2},
+    {"clEnqueueReadBufferRect", 2},  {"clEnqueueWriteBufferRect", 2},
+    {"clEnqueueReadImage", 2},       {"clEnqueueWriteImage", 2},
+    {"clEnqueueMapBuffer", 2},       {"clEnqueueMapImage", 2},
+    {"clEnqueueSVMMemcpy", 1},       {"clEnqueueSVMMap", 1},
+};
+
+/// How a statement uses a command queue.
+enum CommandKind {
+  FinishCommand,
+  KernelLaunch,
+  BlockingCommand,
+  NonBlockingCommand,
+  /// Any other use, such as clFlush or passing the queue to a function.
+  OtherUse
+};
+
+StringRef getCalleeName(const CallExpr *Call) {
+  const FunctionDecl *Callee = Call->getDirectCallee();
+  if (!Callee || !Callee->getIdentifier())
+    return StringRef();
+  return Callee->getName();
+}
+
+bool isBlockingCommand(const CallExpr *Call, const ASTContext &Context) {
+  const StringRef Name = getCalleeName(Call);
+  const auto *Found = llvm::find_if(
+      BlockingCommands, [Name](const std::pair<StringRef, unsigned> &Command) {
+        return Command.first == Name;
+      });
+  if (Found == std::end(BlockingCommands) ||
+      Call->getNumArgs() <= Found->second)
+    return false;
+  const llvm::Optional<int64_t> Blocking =
+      utils::evaluateInteger(Call->getArg(Found->second), Context);
+  return Blocking && *Blocking != 0;
+}
+
+/// Returns the variable or field that holds the command queue passed as the
+/// first argument of \p Call.
+const ValueDecl *getQueue(const CallExpr *Call) {
+  if (Call->getNumArgs() == 0)
+    return nullptr;
+  const Expr *Arg = Call->getArg(0)->IgnoreParenImpCasts();
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(Arg))
+    return Ref->getDecl();
+  if (const auto *Member = dyn_cast<MemberExpr>(Arg))
+    return Member->getMemberDecl();
+  return nullptr;
+}
+
+/// Returns the first OpenCL call on \p Queue within \p S, in source order.
+const CallExpr *findQueueCall(const Stmt *S, const ValueDecl *Queue) {
+  if (!S)
+    return nullptr;
+  if (const auto *Call = dyn_cast<CallExpr>(S))
+    if (getQueue(Call) == Queue && getCalleeName(Call).startswith("cl"))
+      return Call;
+  for (const Stmt *Child : S->children())
+    if (const CallExpr *Call = findQueueCall(Child, Queue))
+      return Call;
+  return nullptr;
+}
+
+CommandKind classify(const Stmt *S, const ValueDecl *Queue,
+                     const ASTContext &Context) {
+  const CallExpr *Call = findQueueCall(S, Queue);
+  if (!Call)
+    return OtherUse;
+  const StringRef Name = getCalleeName(Call);
+  if (Name == "clFinish")
+    return FinishCommand;
+  if (Name == "clEnqueueNDRangeKernel" || Name == "clEnqueueTask")
+    return KernelLaunch;
+  if (isBlockingCommand(Call, Context))
+    return BlockingCommand;
+  if (Name.startswith("clEnqueue"))
+    return NonBlockingCommand;
+  return OtherUse;
+}
+
+/// Returns true if \p E has the same value on every iteration of \p Loop.
+bool isLoopInvariant(const Expr *E, const Stmt *Loop,
+                     const llvm::SmallPtrSetImpl<const VarDecl *> &Modified,
+                     const SourceManager &SM) {
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E))
+    if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+      if (Modified.count(Var) ||
+          (SM.isBeforeInTranslationUnit(Loop->getBeginLoc(),
+                                        Var->getLocation()) &&
+           SM.isBeforeInTranslationUnit(Var->getLocation(),
+                                        Loop->getEndLoc())))
+        return false;
+  return llvm::all_of(E->children(), [&](const Stmt *Child) {
+    const auto *ChildExpr = dyn_cast_or_null<Expr>(Child);
+    return !ChildExpr || isLoopInvariant(ChildExpr, Loop, Modified, SM);
+  });
+}
+
+} // namespace
+
+void HostSerializationCheck::registerMatchers(MatchFinder *Finder) {
+  const auto InLoop = hasAncestor(
+      stmt(anyOf(forStmt(), whileStmt(), doStmt(), cxxForRangeStmt()))
+          .bind("loop"));
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(
+                   "clEnqueueReadBuffer", "clEnqueueWriteBuffer",
+                   "clEnqueueReadBufferRect", "clEnqueueWriteBufferRect",
+                   "clEnqueueReadImage", "clEnqueueWriteImage",
+                   "clEnqueueMapBuffer", "clEnqueueMapImage",
+                   "clEnqueueSVMMemcpy", "clEnqueueSVMMap"))),
+               InLoop)
+          .bind("transfer"),
+      this);
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(
+                   "clCreateBuffer", "clCreateSubBuffer", "clCreateImage",
+                   "clCreateKernel", "clCreateProgramWithSource",
+                   "clCreateProgramWithBinary", "clBuildProgram"))),
+               InLoop)
+          .bind("create"),
+      this);
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasName("clFinish")))).bind("finish"),
+      this);
+}
+
+void HostSerializationCheck::check(const MatchFinder::MatchResult &Result) {
+  ASTContext &Context = *Result.Context;
+
+  if (const auto *Finish = Result.Nodes.getNodeAs<CallExpr>("finish")) {
+    checkFinish(Finish, Context);
+    return;
+  }
+
+  if (const auto *Transfer = Result.Nodes.getNodeAs<CallExpr>("transfer")) {
+    if (!isBlockingCommand(Transfer, Context))
+      return;
+    diag(Transfer->getBeginLoc(),
+         "blocking %0 inside a loop stalls the host until the transfer "
+         "completes; pass CL_FALSE and wait on its event, double-buffering "
+         "the data so that transfers overlap with the kernels")
+        << Transfer->getDirectCallee();
+    return;
+  }
+
+  // Objects created from different arguments on every iteration, such as one
+  // kernel per name, are not redundant.
+  const auto *Create = Result.Nodes.getNodeAs<CallExpr>("create");
+  const auto *Loop = Result.Nodes.getNodeAs<Stmt>("loop");
+  llvm::SmallPtrSet<const VarDecl *, 8> Modified;
+  utils::collectModifiedVars(Loop, Modified);
+  for (const Expr *Arg : Create->arguments()) {
+    // Output arguments, such as the error code, may change.
+    if (const auto *Unary = dyn_cast<UnaryOperator>(Arg->IgnoreParenImpCasts()))
+      if (Unary->getOpcode() == UO_AddrOf)
+        continue;
+    if (!isLoopInvariant(Arg, Loop, Modified, *Result.SourceManager))
+      return;
+  }
+  diag(Create->getBeginLoc(),
+       "%0 is called with the same arguments on every iteration of the loop; "
+       "create the object once before the loop and reuse it")
+      << Create->getDirectCallee();
+}
+
+void HostSerializationCheck::checkFinish(const CallExpr *Finish,
+                                         ASTContext &Context) {
+  const ValueDecl *Queue = getQueue(Finish);
+  if (!Queue)
+    return;
+
+  // Find the statement of the enclosing block that contains the call.
+  const Stmt *Statement = Finish;
+  const CompoundStmt *Block = nullptr;
+  ast_type_traits::DynTypedNode Node =
+      ast_type_traits::DynTypedNode::create(*Finish);
+  while (!Block) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() || Parents[0].get<FunctionDecl>())
+      return;
+    Node = Parents[0];
+    Block = Node.get<CompoundStmt>();
+    if (Block)
+      break;
+    if (const auto *S = Node.get<Stmt>())
+      Statement = S;
+  }
+  const llvm::SmallVector<const Stmt *, 16> Body(Block->body_begin(),
+                                                 Block->body_end());
+  const size_t Position = llvm::find(Body, Statement) - Body.begin();
+  if (Position == Body.size())
+    return;
+
+  const Stmt *Previous = nullptr;
+  for (size_t I = Position; I-- != 0;)
+    if (utils::countReferences(Body[I], Queue)) {
+      Previous = Body[I];
+      break;
+    }
+  if (!Previous)
+    return;
+  const CommandKind PreviousKind = classify(Previous, Queue, Context);
+
+  if (PreviousKind == FinishCommand || PreviousKind == BlockingCommand) {
+    diag(Finish->getBeginLoc(),
+         "redundant clFinish; the host already waited for %0 at the previous "
+         "%select{clFinish|blocking command}1")
+        << Queue << (PreviousKind == BlockingCommand);
+    diag(Previous->getBeginLoc(), "previous command on %0 is here",
+         DiagnosticIDs::Note)
+        << Queue;
+    return;
+  }
+  if (PreviousKind != KernelLaunch)
+    return;
+
+  // The kernel's results only reach the host through a later command. If
+  // that command is enqueued on the same in-order queue, it starts after the
+  // kernel anyway. In a loop body, the next command may be in the next
+  // iteration.
+  const auto Parents = Context.getParents(*Block);
+  const Stmt *Parent = Parents.empty() ? nullptr : Parents[0].get<Stmt>();
+  const bool IsLoopBody =
+      Parent && (utils::isLoop(Parent) || isa<CXXForRangeStmt>(Parent));
+  const Stmt *Next = nullptr;
+  for (size_t I = 1; I != Body.size() && !Next; ++I) {
+    const size_t Index = Position + I;
+    if (Index >= Body.size() && !IsLoopBody)
+      break;
+    if (utils::countReferences(Body[Index % Body.size()], Queue))
+      Next = Body[Index % Body.size()];
+  }
+  if (!Next)
+    return;
+  const CommandKind NextKind = classify(Next, Queue, Context);
+  if (NextKind == FinishCommand || NextKind == OtherUse)
+    return;
+  diag(Finish->getBeginLoc(),
+       "clFinish after a kernel launch stalls the host, although the next "
+       "command on the in-order queue %0 starts after the kernel anyway; wait "
+       "on the event of the command whose results the host needs instead")
+      << Queue;
+  diag(Next->getBeginLoc(), "next command on %0 is here", DiagnosticIDs::Note)
+      << Queue;
+}
+
+} // namespace OpenCL
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,40 @@
+//===--- HostSerializationCheck.h - clang-tidy ------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_HOSTSERIALIZATIONCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_HOSTSERIALIZATIONCHECK_H
+
+#include "../ClangTidy.h"
+
+namespace clang {
+namespace tidy {
+namespace OpenCL {
+
+/// Finds host code that makes the host wait for the device more than needed:
+/// blocking reads, writes and maps inside loops, buffers, kernels and
+/// programs created on every iteration of a loop, and calls to clFinish that
+/// do not wait for anything the host needs.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/opencl-host-serialization.html
+class HostSerializationCheck : public ClangTidyCheck {
+public:
+  HostSerializationCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+
+private:
+  void checkFinish(const CallExpr *Finish, ASTContext &Context);
+};
+
+} // namespace OpenCL
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_HOSTSERIALIZATIONCHECK_H
@@ -10,8 +10,11 @@
 #include "../ClangTidy.h"
 #include "../ClangTidyModule.h"
 #include "../ClangTidyModuleRegistry.h"
+#include "ConstantCacheSizeCheck.h"
+#include "HostSerializationCheck.h"
 #include "PossiblyUnreachableBarrierCheck.h"
 #include "RecursionNotSupportedCheck.h"
+#include "VectorizableKernelCheck.h"
 
 
 using namespace clang::ast_matchers;
@@ -23,10 +26,16 @@ namespace OpenCL {
 class OpenCLModule : public ClangTidyModule {
 public:
   void addCheckFactories(ClangTidyCheckFactories &CheckFactories) override {
+    CheckFactories.registerCheck<ConstantCacheSizeCheck>(
+        "opencl-constant-cache-size");
+    CheckFactories.registerCheck<HostSerializationCheck>(
+        "opencl-host-serialization");
     CheckFactories.registerCheck<PossiblyUnreachableBarrierCheck>(
         "opencl-possibly-unreachable-barrier");
     CheckFactories.registerCheck<RecursionNotSupportedCheck>(
         "opencl-recursion-not-supported");
+    CheckFactories.registerCheck<VectorizableKernelCheck>(
+        "opencl-vectorizable-kernel");
   }
 };
 
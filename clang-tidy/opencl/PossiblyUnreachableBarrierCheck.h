@@ -11,27 +11,34 @@
 #define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_POSSIBLY_UNREACHABLE_BARRIER_H
 
 #include "../ClangTidy.h"
+#include "../utils/DivergenceAnalyzer.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace clang {
 namespace tidy {
 namespace OpenCL {
 
-/// FIXME: Write a short description.
+/// Finds barriers, and calls to functions that execute a barrier, that some
+/// work-items of a work-group may not reach because a branch whose condition
+/// depends on the work-item ID decides whether they are executed.
 ///
 /// For the user-facing documentation see:
 /// http://clang.llvm.org/extra/clang-tidy/checks/OpenCL-possibly-unreachable-barrier.html
 class PossiblyUnreachableBarrierCheck : public ClangTidyCheck {
 private:
-  std::vector<const VarDecl *> IDDepVars;
-  std::vector<const FieldDecl *> IDDepFields;
+  /// Caches whether each function executes a barrier, directly or through
+  /// the functions it calls.
+  llvm::DenseMap<const FunctionDecl *, bool> ReachesBarrier;
+  utils::DivergenceAnalyzer Divergence;
+
+  bool reachesBarrier(const FunctionDecl *Func);
+
 public:
   PossiblyUnreachableBarrierCheck(StringRef Name, ClangTidyContext *Context)
       : ClangTidyCheck(Name, Context) {}
   void registerMatchers(ast_matchers::MatchFinder *Finder) override;
   void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
-  const DeclRefExpr * hasIDDepDeclRef(const Expr * e);
-  const MemberExpr * hasIDDepMember(const Expr * e);
-  void preorderFlattenStmt(const Stmt * s, std::list<const Stmt *> * out);
+  void onStartOfTranslationUnit() override;
 };
 
 } // namespace OpenCL
@@ -9,6 +9,11 @@
 #include "RecursionNotSupportedCheck.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Analysis/CallGraph.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SCCIterator.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include <algorithm>
 #include <sstream>
 
 using namespace clang::ast_matchers;
@@ -17,91 +22,126 @@ namespace clang {
 namespace tidy {
 namespace OpenCL {
 
-void RecursionNotSupportedCheck::registerMatchers(MatchFinder *Finder) {
-  Finder->addMatcher(functionDecl().bind("functionDecl"), this);
-  Finder->addMatcher(
-      declRefExpr(to(functionDecl())).bind("functionCall"), this);
+namespace {
+
+const FunctionDecl *getDefinition(const CallGraphNode *Node) {
+  const auto *Func = dyn_cast_or_null<FunctionDecl>(Node->getDecl());
+  const FunctionDecl *Definition = nullptr;
+  if (Func && Func->hasBody(Definition))
+    return Definition;
+  return Func;
 }
 
-void RecursionNotSupportedCheck::check(const MatchFinder::MatchResult &Result) {
-  auto MatchedFunDecl = Result.Nodes.getNodeAs<FunctionDecl>("functionDecl");
-  auto MatchedFunCall = Result.Nodes.getNodeAs<DeclRefExpr>("functionCall");
+/// Returns the first call to \p Callee within \p S, in source order.
+const CallExpr *findCall(const Stmt *S, const FunctionDecl *Callee) {
+  if (!S)
+    return nullptr;
+  if (const auto *Call = dyn_cast<CallExpr>(S))
+    if (const FunctionDecl *Func = Call->getDirectCallee())
+      if (Func->getCanonicalDecl() == Callee->getCanonicalDecl())
+        return Call;
+  for (const Stmt *Child : S->children())
+    if (const CallExpr *Call = findCall(Child, Callee))
+      return Call;
+  return nullptr;
+}
 
-  if (MatchedFunDecl) {
-    handleFunctionDecl(MatchedFunDecl);
-  } else {
-    handleFunctionCall(MatchedFunCall, Result.SourceManager);
-  }
-  
+} // namespace
+
+void RecursionNotSupportedCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(translationUnitDecl().bind("unit"), this);
 }
 
-void RecursionNotSupportedCheck::handleFunctionDecl(
-    const FunctionDecl *FunDecl) {
-  std::string FunDeclName = FunDecl->getNameInfo().getName().getAsString();
-  Locations[FunDeclName] = FunDecl->getSourceRange();
+void RecursionNotSupportedCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Unit = Result.Nodes.getNodeAs<TranslationUnitDecl>("unit");
+  CallGraph Graph;
+  Graph.addToCallGraph(const_cast<TranslationUnitDecl *>(Unit));
+  // Tarjan's algorithm visits every function and call once.
+  for (auto SCC = llvm::scc_begin(&Graph); !SCC.isAtEnd(); ++SCC)
+    handleComponent(*SCC, *Result.SourceManager);
 }
 
-void RecursionNotSupportedCheck::handleFunctionCall(const DeclRefExpr *FunCall,
-    const SourceManager *SM) {
-  std::string FunCallName = FunCall->getNameInfo().getName().getAsString();
-  // Update Callees map
-  auto Iter = Callers.find(FunCallName);
-  if (Iter == Callers.end()) {  // First instance of a call to this function
-    Callers[FunCallName] = std::vector<std::pair<SourceLocation,std::string>>();
-  }
-  for (auto const &I : Locations) {
-    if (SM->isPointWithin(FunCall->getLocation(), I.second.getBegin(), 
-        I.second.getEnd())) {
-      Callers[FunCallName].push_back(std::make_pair(FunCall->getBeginLoc(),
-                                     I.first));
+void RecursionNotSupportedCheck::handleComponent(
+    llvm::ArrayRef<CallGraphNode *> SCC, const SourceManager &SM) {
+  // The root of the graph is never part of a cycle.
+  if (SCC.size() == 1 && !SCC.front()->getDecl())
+    return;
+
+  // Start from the function that is declared first, so that the cycle is
+  // reported at a stable place.
+  llvm::SmallPtrSet<const CallGraphNode *, 8> InComponent(SCC.begin(),
+                                                          SCC.end());
+  CallGraphNode *Start = *std::min_element(
+      SCC.begin(), SCC.end(),
+      [&SM](const CallGraphNode *LHS, const CallGraphNode *RHS) {
+        return SM.isBeforeInTranslationUnit(LHS->getDecl()->getLocation(),
+                                            RHS->getDecl()->getLocation());
+      });
+
+  // Find the shortest path back to Start with a breadth-first search. A single
+  // function that does not call itself has none.
+  llvm::DenseMap<const CallGraphNode *, CallGraphNode *> Parents;
+  llvm::SmallVector<CallGraphNode *, 8> Queue{Start};
+  Parents[Start] = nullptr;
+  CallGraphNode *Last = nullptr;
+  for (size_t I = 0; I != Queue.size() && !Last; ++I) {
+    for (CallGraphNode *Callee : *Queue[I]) {
+      if (Callee == Start) {
+        Last = Queue[I];
+        break;
+      }
+      if (InComponent.count(Callee) &&
+          Parents.try_emplace(Callee, Queue[I]).second)
+        Queue.push_back(Callee);
     }
   }
-  // Check if function call is recursive
-  std::string RecursivePath = isRecursive(FunCallName, FunCallName, 0, SM);
-  if (!RecursivePath.empty()) {
-    diag(FunCall->getBeginLoc(), 
-         "The call to function %0 is recursive, which is not supported by "
-         "OpenCL.\n%1", DiagnosticIDs::Error)
-        << FunCallName << RecursivePath;
-  }
-}
+  if (!Last)
+    return;
 
-std::string RecursionNotSupportedCheck::isRecursive(std::string &FunCallName, 
-    std::string &CallerName, unsigned Depth, const SourceManager *SM) {
-  if (Depth == MaxRecursionDepth) {
-    return "";
-  }
-  for(std::pair<SourceLocation,std::string> &Caller : Callers[CallerName]) {
-    if (Caller.second.compare(FunCallName) == 0) {
-      return buildStringPath(CallerName, FunCallName, SM, Caller.first);
-    }
-    std::string StringPath = isRecursive(FunCallName, Caller.second, Depth+1,
-                                         SM);
-    if (!StringPath.empty()) {
-      std::ostringstream StringStream;
-      StringStream << buildStringPath(CallerName, Caller.second, SM,
-                                      Caller.first) 
-          << "\n" << StringPath;
-      return StringStream.str();
-    }
+  // The functions of the cycle, from Start to the one calling it back.
+  llvm::SmallVector<const FunctionDecl *, 8> Cycle;
+  for (const CallGraphNode *Node = Last; Node; Node = Parents.lookup(Node))
+    Cycle.push_back(getDefinition(Node));
+  std::reverse(Cycle.begin(), Cycle.end());
+  if (Cycle.size() > MaxRecursionDepth)
+    return;
+
+  const CallExpr *Recursive = findCall(Cycle.back()->getBody(), Cycle.front());
+  if (!Recursive)
+    return;
+  std::ostringstream StringStream;
+  StringStream << buildStringPath(Cycle.front(), Cycle.back(), SM,
+                                  Recursive->getBeginLoc());
+  for (size_t I = Cycle.size() - 1; I > 0; --I) {
+    const CallExpr *Call = findCall(Cycle[I - 1]->getBody(), Cycle[I]);
+    if (!Call)
+      return;
+    StringStream << "\n"
+                 << buildStringPath(Cycle[I], Cycle[I - 1], SM,
+                                    Call->getBeginLoc());
   }
-  return "";
+  diag(Recursive->getBeginLoc(),
+       "The call to function %0 is recursive, which is not supported by "
+       "OpenCL.\n%1", DiagnosticIDs::Error)
+      << Cycle.front()->getNameAsString() << StringStream.str();
 }
 
 std::string RecursionNotSupportedCheck::buildStringPath(
-    std::string &FunCallName, std::string &CallerName, const SourceManager *SM,
-    SourceLocation Loc) {
+    const FunctionDecl *Callee, const FunctionDecl *Caller,
+    const SourceManager &SM, SourceLocation Loc) {
   std::ostringstream StringStream;
   StringStream << "\t";
-  std::pair<FileID, unsigned> FileOffset = SM->getDecomposedLoc(Loc);
-  std::string FilePath = SM->getFileEntryForID(
-      FileOffset.first)->tryGetRealPathName();
-  unsigned LineNum = SM->getLineNumber(FileOffset.first, FileOffset.second);
-  unsigned ColNum = SM->getColumnNumber(FileOffset.first, FileOffset.second);
-  StringStream << FunCallName << " is called by " << CallerName << " in "
-      << FilePath << ":" << LineNum << ":" << ColNum;
-  std::string StringPath = StringStream.str();
-  return StringPath;
+  std::pair<FileID, unsigned> FileOffset =
+      SM.getDecomposedLoc(SM.getExpansionLoc(Loc));
+  std::string FilePath;
+  if (const FileEntry *File = SM.getFileEntryForID(FileOffset.first))
+    FilePath = File->tryGetRealPathName();
+  unsigned LineNum = SM.getLineNumber(FileOffset.first, FileOffset.second);
+  unsigned ColNum = SM.getColumnNumber(FileOffset.first, FileOffset.second);
+  StringStream << Callee->getNameAsString() << " is called by "
+      << Caller->getNameAsString() << " in " << FilePath << ":" << LineNum
+      << ":" << ColNum;
+  return StringStream.str();
 }
 
 void RecursionNotSupportedCheck::storeOptions(
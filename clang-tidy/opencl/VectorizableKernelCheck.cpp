@@ -0,0 +1,291 @@
+//===--- VectorizableKernelCheck.cpp - clang-tidy -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "VectorizableKernelCheck.h"
+#include "../utils/InductionVariable.h"
+#include "../utils/KernelClassifier.h"
+#include "../utils/LexerUtils.h"
+#include "../utils/MemoryAccessPattern.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace clang::ast_matchers;
+
+namespace clang {
+namespace tidy {
+namespace OpenCL {
+
+namespace {
+
+/// The scalar loads from, or stores to, an array whose indices only differ by
+/// a constant, such as ``A[4 * i]`` and ``A[4 * i + 1]``.
+struct AccessGroup {
+  const VarDecl *Base = nullptr;
+  bool IsWrite = false;
+  /// The index without its constant offset, and its profile.
+  const Expr *Index = nullptr;
+  llvm::FoldingSetNodeID ID;
+  llvm::SmallVector<const Expr *, 4> Accesses;
+  llvm::SmallVector<int64_t, 4> Offsets;
+};
+
+/// Splits \p Index into an expression and a constant offset, so that
+/// ``4 * i + 2`` gives ``4 * i`` and 2.
+std::pair<const Expr *, int64_t> splitOffset(const Expr *Index,
+                                             const ASTContext &Context) {
+  Index = Index->IgnoreParenImpCasts();
+  const auto *BinOp = dyn_cast<BinaryOperator>(Index);
+  if (!BinOp ||
+      (BinOp->getOpcode() != BO_Add && BinOp->getOpcode() != BO_Sub))
+    return {Index, 0};
+  if (llvm::Optional<int64_t> Offset =
+          utils::evaluateInteger(BinOp->getRHS(), Context))
+    return {BinOp->getLHS()->IgnoreParenImpCasts(),
+            BinOp->getOpcode() == BO_Sub ? -*Offset : *Offset};
+  if (BinOp->getOpcode() == BO_Add)
+    if (llvm::Optional<int64_t> Offset =
+            utils::evaluateInteger(BinOp->getLHS(), Context))
+      return {BinOp->getRHS()->IgnoreParenImpCasts(), *Offset};
+  return {Index, 0};
+}
+
+/// Returns true if the offsets of \p Group are exactly 0 to n - 1, with n a
+/// width that vloadn and vstoren support.
+bool coversVector(const AccessGroup &Group, unsigned &Width) {
+  llvm::SmallVector<int64_t, 4> Offsets(Group.Offsets);
+  llvm::sort(Offsets);
+  Offsets.erase(std::unique(Offsets.begin(), Offsets.end()), Offsets.end());
+  Width = Offsets.size();
+  if (Width != 2 && Width != 3 && Width != 4 && Width != 8 && Width != 16)
+    return false;
+  for (unsigned I = 0; I != Width; ++I)
+    if (Offsets[I] != static_cast<int64_t>(I))
+      return false;
+  return true;
+}
+
+/// Returns the name of the OpenCL vector type of \p Width elements of type
+/// \p Element, such as ``float4``, or an empty string if \p Element is not a
+/// scalar OpenCL type.
+std::string getVectorTypeName(QualType Element, unsigned Width) {
+  const auto *Builtin = Element->getAs<BuiltinType>();
+  if (!Builtin)
+    return "";
+  StringRef Name;
+  switch (Builtin->getKind()) {
+  case BuiltinType::Char_S:
+  case BuiltinType::SChar:
+    Name = "char";
+    break;
+  case BuiltinType::Char_U:
+  case BuiltinType::UChar:
+    Name = "uchar";
+    break;
+  case BuiltinType::Short:
+    Name = "short";
+    break;
+  case BuiltinType::UShort:
+    Name = "ushort";
+    break;
+  case BuiltinType::Int:
+    Name = "int";
+    break;
+  case BuiltinType::UInt:
+    Name = "uint";
+    break;
+  case BuiltinType::Long:
+    Name = "long";
+    break;
+  case BuiltinType::ULong:
+    Name = "ulong";
+    break;
+  case BuiltinType::Half:
+    Name = "half";
+    break;
+  case BuiltinType::Float:
+    Name = "float";
+    break;
+  case BuiltinType::Double:
+    Name = "double";
+    break;
+  default:
+    return "";
+  }
+  return (Name + llvm::Twine(Width)).str();
+}
+
+/// Returns true if \p S calls a function defined in the translation unit,
+/// whose work-items are not known to execute the same instructions, or an
+/// atomic function, which serializes the work-items.
+bool hasUnvectorizableCall(const Stmt *S) {
+  if (!S)
+    return false;
+  if (const auto *Call = dyn_cast<CallExpr>(S)) {
+    const FunctionDecl *Callee = Call->getDirectCallee();
+    if (!Callee || Callee->hasBody())
+      return true;
+    if (Callee->getIdentifier() && (Callee->getName().startswith("atomic_") ||
+                                    Callee->getName().startswith("atom_")))
+      return true;
+  }
+  return llvm::any_of(S->children(), hasUnvectorizableCall);
+}
+
+} // namespace
+
+void VectorizableKernelCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      functionDecl(isDefinition(), hasAttr(attr::Kind::OpenCLKernel))
+          .bind("kernel"),
+      this);
+}
+
+void VectorizableKernelCheck::onStartOfTranslationUnit() {
+  Divergence.reset(getTranslationUnitAnalysis<utils::IdDependencyAnalyzer>());
+}
+
+void VectorizableKernelCheck::check(const MatchFinder::MatchResult &Result) {
+  const auto *Kernel = Result.Nodes.getNodeAs<FunctionDecl>("kernel");
+  ASTContext &Context = *Result.Context;
+  utils::KernelClassifier &Classifier =
+      getTranslationUnitAnalysis<utils::KernelClassifier>();
+  if (Classifier.classify(Kernel, Context).Model !=
+      utils::KernelClassifier::NDRange)
+    return;
+
+  const utils::StrideAnalyzer Strides(
+      Kernel, Divergence.analyzeIDDependency(Kernel, Context), Context);
+
+  // Group the accesses whose stride between work-items is not contiguous by
+  // array and index, and look for groups that access consecutive elements.
+  llvm::SmallVector<utils::MemoryAccess, 16> Accesses;
+  utils::collectMemoryAccesses(Kernel->getBody(), Accesses);
+  llvm::SmallVector<const utils::MemoryAccess *, 16> GlobalAccesses;
+  llvm::SmallVector<AccessGroup, 8> Groups;
+  bool Vectorizable = true;
+  QualType VectorElement;
+  for (const utils::MemoryAccess &Access : Accesses) {
+    const QualType Element =
+        utils::getElementType(Access.Base->getType(), Context);
+    if (Element.isNull() || Element->isIncompleteType() ||
+        Element.getAddressSpace() != LangAS::opencl_global)
+      continue;
+    if (Access.IsMultiDimensional || !Access.Index) {
+      Vectorizable = false;
+      continue;
+    }
+    const utils::AccessStride Stride = Strides.getStride(Access.Index);
+    if (Stride.isUniform())
+      continue;
+    GlobalAccesses.push_back(&Access);
+    if (Stride.isContiguous()) {
+      if (VectorElement.isNull())
+        VectorElement = Element;
+      continue;
+    }
+
+    const std::pair<const Expr *, int64_t> Split =
+        splitOffset(Access.Index, Context);
+    llvm::FoldingSetNodeID ID;
+    Split.first->Profile(ID, Context, /*Canonical=*/true);
+    for (const bool IsWrite : {false, true}) {
+      if (IsWrite ? !Access.IsWrite : !Access.IsRead)
+        continue;
+      auto Group = llvm::find_if(Groups, [&](const AccessGroup &Other) {
+        return Other.Base == Access.Base && Other.IsWrite == IsWrite &&
+               Other.ID == ID;
+      });
+      if (Group == Groups.end()) {
+        Groups.emplace_back();
+        Group = Groups.end() - 1;
+        Group->Base = Access.Base;
+        Group->IsWrite = IsWrite;
+        Group->Index = Split.first;
+        Group->ID = ID;
+      }
+      Group->Accesses.push_back(Access.Access);
+      Group->Offsets.push_back(Split.second);
+    }
+  }
+
+  // A group of n accesses to consecutive elements is vectorized if the
+  // work-items access consecutive groups.
+  llvm::SmallPtrSet<const Expr *, 16> Vectorized;
+  for (const AccessGroup &Group : Groups) {
+    unsigned Width = 0;
+    if (!coversVector(Group, Width))
+      continue;
+    const utils::AccessStride Stride = Strides.getStride(Group.Index);
+    if (Stride.Kind != utils::AccessStride::Constant ||
+        Stride.Value != static_cast<int64_t>(Width))
+      continue;
+    Vectorized.insert(Group.Accesses.begin(), Group.Accesses.end());
+    diag(Group.Accesses.front()->getBeginLoc(),
+         "%0 scalar %select{loads from|stores to}1 %2 access consecutive "
+         "elements; consider replacing them with a single "
+         "%select{vload|vstore}1%0")
+        << Width << Group.IsWrite << Group.Base;
+  }
+
+  // SIMD vectorization needs every work-item to execute the same instructions
+  // and to access global memory next to its neighbours.
+  if (!Vectorizable || GlobalAccesses.empty() ||
+      Divergence.analyze(Kernel, Context).hasDivergentRegions() ||
+      hasUnvectorizableCall(Kernel->getBody()) ||
+      Kernel->hasAttr<VecTypeHintAttr>() ||
+      utils::lexer::hasLeadingAttribute(Kernel, "num_simd_work_items",
+                                        *Result.SourceManager, getLangOpts()))
+    return;
+  for (const utils::MemoryAccess *Access : GlobalAccesses)
+    if (!Strides.getStride(Access->Index).isContiguous() &&
+        !Vectorized.count(Access->Access))
+      return;
+  if (VectorElement.isNull())
+    VectorElement = utils::getElementType(
+        GlobalAccesses.front()->Base->getType(), Context);
+
+  // num_simd_work_items must divide the work-group size, which has to be
+  // fixed by reqd_work_group_size.
+  unsigned SIMDWorkItems = 1;
+  while (SIMDWorkItems * 2 <= MaxSIMDWorkItems)
+    SIMDWorkItems *= 2;
+  const auto *Size = Kernel->getAttr<ReqdWorkGroupSizeAttr>();
+  while (Size && SIMDWorkItems > 1 && Size->getXDim() % SIMDWorkItems != 0)
+    SIMDWorkItems /= 2;
+  if (Size && SIMDWorkItems > 1) {
+    diag(Kernel->getLocation(),
+         "kernel %0 executes the same instructions in all work-items and "
+         "accesses global memory contiguously; consider vectorizing it with "
+         "num_simd_work_items(%1)")
+        << Kernel << SIMDWorkItems
+        << FixItHint::CreateInsertion(
+               Kernel->getBeginLoc(),
+               ("__attribute__((num_simd_work_items(" +
+                llvm::Twine(SIMDWorkItems) + ")))\n")
+                   .str());
+    return;
+  }
+  const std::string VectorType = getVectorTypeName(VectorElement, 4);
+  diag(Kernel->getLocation(),
+       "kernel %0 executes the same instructions in all work-items and "
+       "accesses global memory contiguously; consider vectorizing it with "
+       "%select{vec_type_hint(%2), or |}1num_simd_work_items and a "
+       "reqd_work_group_size that is a multiple of the SIMD width")
+      << Kernel << VectorType.empty() << VectorType;
+}
+
+void VectorizableKernelCheck::storeOptions(ClangTidyOptions::OptionMap &Opts) {
+  Options.store(Opts, "MaxSIMDWorkItems", MaxSIMDWorkItems);
+}
+
+} // namespace OpenCL
+} // namespace tidy
+} // namespace clang
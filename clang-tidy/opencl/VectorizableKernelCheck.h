@@ -0,0 +1,46 @@
+//===--- VectorizableKernelCheck.h - clang-tidy -----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_VECTORIZABLEKERNELCHECK_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_VECTORIZABLEKERNELCHECK_H
+
+#include "../ClangTidy.h"
+#include "../utils/DivergenceAnalyzer.h"
+
+namespace clang {
+namespace tidy {
+namespace OpenCL {
+
+/// Finds NDRange kernels whose work-items all execute the same instructions
+/// and access global memory contiguously, and suggests vectorizing them with
+/// num_simd_work_items or vec_type_hint. Also finds groups of scalar accesses
+/// to consecutive elements that a single vloadn or vstoren can perform.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/opencl-vectorizable-kernel.html
+class VectorizableKernelCheck : public ClangTidyCheck {
+  const unsigned MaxSIMDWorkItems;
+
+public:
+  VectorizableKernelCheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context),
+        MaxSIMDWorkItems(Options.get("MaxSIMDWorkItems", 16U)) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void storeOptions(ClangTidyOptions::OptionMap &Opts) override;
+  void onStartOfTranslationUnit() override;
+
+private:
+  utils::DivergenceAnalyzer Divergence;
+};
+
+} // namespace OpenCL
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_OPENCL_VECTORIZABLEKERNELCHECK_H
@@ -0,0 +1,197 @@
+//===--- DivergenceAnalyzer.cpp - clang-tidy ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "DivergenceAnalyzer.h"
+#include "clang/Analysis/Analyses/Dominators.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include <tuple>
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+namespace {
+
+const Expr *getCondition(const Stmt *S) {
+  if (const auto *If = dyn_cast<IfStmt>(S))
+    return If->getCond();
+  if (const auto *For = dyn_cast<ForStmt>(S))
+    return For->getCond();
+  if (const auto *While = dyn_cast<WhileStmt>(S))
+    return While->getCond();
+  if (const auto *Do = dyn_cast<DoStmt>(S))
+    return Do->getCond();
+  if (const auto *Switch = dyn_cast<SwitchStmt>(S))
+    return Switch->getCond();
+  if (const auto *Conditional = dyn_cast<AbstractConditionalOperator>(S))
+    return Conditional->getCond();
+  return nullptr;
+}
+
+bool isLogicalOperator(const Stmt *S) {
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(S))
+    return BinOp->isLogicalOp();
+  if (const auto *UnOp = dyn_cast<UnaryOperator>(S))
+    return UnOp->getOpcode() == UO_LNot;
+  return false;
+}
+
+/// Returns the statement that branches at the end of \p Block and its
+/// condition. The blocks of a short-circuit condition such as ``a && b``
+/// belong to the statement whose condition it is.
+std::pair<const Stmt *, const Expr *> getControl(const CFGBlock &Block,
+                                                 const ParentMap &Parents) {
+  const Stmt *Terminator = Block.getTerminatorStmt();
+  if (!Terminator)
+    return {nullptr, nullptr};
+  if (const Expr *Condition = getCondition(Terminator))
+    return {Terminator, Condition};
+  if (!isLogicalOperator(Terminator))
+    return {nullptr, nullptr};
+
+  const Stmt *Current = Terminator;
+  while (const Stmt *Parent = Parents.getParentIgnoreParenImpCasts(Current)) {
+    if (isLogicalOperator(Parent)) {
+      Current = Parent;
+      continue;
+    }
+    const Expr *Condition = getCondition(Parent);
+    if (Condition && Condition->IgnoreParenImpCasts() == Current)
+      return {Parent, Condition};
+    break;
+  }
+  return {Current, cast<Expr>(Current)};
+}
+
+const CFGBlock *getImmediatePostDominator(CFGPostDomTree &PostDom,
+                                          const CFGBlock *Block) {
+  auto *Node = PostDom.getBase().getNode(const_cast<CFGBlock *>(Block));
+  if (!Node || !Node->getIDom())
+    return nullptr;
+  return Node->getIDom()->getBlock();
+}
+
+} // namespace
+
+llvm::ArrayRef<DivergenceAnalyzer::DivergentBranch>
+DivergenceAnalyzer::FunctionInfo::getDivergentBranches(const Stmt *S) const {
+  if (!StmtMap)
+    return llvm::None;
+  auto Found = Branches.find(StmtMap->getBlock(S));
+  if (Found == Branches.end())
+    return llvm::None;
+  return Found->second;
+}
+
+std::unique_ptr<DivergenceAnalyzer::FunctionInfo>
+DivergenceAnalyzer::analyzeImpl(const FunctionDecl *Func, ASTContext &Context) {
+  auto Info = std::make_unique<FunctionInfo>();
+  Stmt *Body = Func->getBody();
+  if (!Body)
+    return Info;
+  CFG::BuildOptions Options;
+  Options.setAllAlwaysAdd();
+  Info->TheCFG = CFG::buildCFG(Func, Body, &Context, Options);
+  if (!Info->TheCFG)
+    return Info;
+  Info->Parents = std::make_unique<ParentMap>(Body);
+  Info->StmtMap.reset(
+      CFGStmtMap::Build(Info->TheCFG.get(), Info->Parents.get()));
+  CFGPostDomTree PostDom(Info->TheCFG.get());
+  const IdDependencyAnalyzer::FunctionInfo &IDInfo =
+      analyzeIDDependency(Func, Context);
+
+  // A block is control dependent on a branch if it lies on the post-dominator
+  // tree path from a successor of the branch up to, but excluding, the
+  // immediate post-dominator of the branch.
+  llvm::DenseMap<const CFGBlock *, llvm::SmallVector<const CFGBlock *, 2>>
+      ControlDependencies;
+  llvm::DenseMap<const CFGBlock *, DivergentBranch> Divergent;
+  for (const CFGBlock *Block : *Info->TheCFG) {
+    if (llvm::count_if(Block->succs(), [](const CFGBlock *Succ) {
+          return Succ != nullptr;
+        }) < 2)
+      continue;
+    const CFGBlock *PostDominator = getImmediatePostDominator(PostDom, Block);
+    for (const CFGBlock *Succ : Block->succs()) {
+      for (const CFGBlock *Runner = Succ; Runner && Runner != PostDominator;
+           Runner = getImmediatePostDominator(PostDom, Runner)) {
+        auto &Dependencies = ControlDependencies[Runner];
+        if (!llvm::is_contained(Dependencies, Block))
+          Dependencies.push_back(Block);
+      }
+    }
+
+    DivergentBranch Branch;
+    std::tie(Branch.Control, Branch.Condition) =
+        getControl(*Block, *Info->Parents);
+    if (!Branch.Condition)
+      continue;
+    Branch.Cause = IdDependencyAnalyzer::findIDFunctionCall(Branch.Condition);
+    if (!Branch.Cause)
+      Branch.Cause = IDInfo.findIDDependentReference(Branch.Condition);
+    if (!Branch.Cause)
+      Branch.Cause = IDInfo.findIDCall(Branch.Condition);
+    if (Branch.Cause)
+      Divergent[Block] = Branch;
+  }
+
+  // A block executed under a uniform branch that is itself under a divergent
+  // one diverges as well, so follow the dependencies transitively.
+  for (const CFGBlock *Block : *Info->TheCFG) {
+    llvm::SmallPtrSet<const CFGBlock *, 8> Visited;
+    llvm::SmallVector<const CFGBlock *, 8> Worklist{Block};
+    llvm::SmallVector<DivergentBranch, 2> Branches;
+    for (size_t I = 0; I != Worklist.size(); ++I) {
+      auto Found = ControlDependencies.find(Worklist[I]);
+      if (Found == ControlDependencies.end())
+        continue;
+      for (const CFGBlock *Dependency : Found->second) {
+        if (!Visited.insert(Dependency).second)
+          continue;
+        Worklist.push_back(Dependency);
+        auto Branch = Divergent.find(Dependency);
+        if (Branch != Divergent.end() &&
+            llvm::none_of(Branches, [&](const DivergentBranch &Other) {
+              return Other.Control == Branch->second.Control;
+            }))
+          Branches.push_back(Branch->second);
+      }
+    }
+    if (!Branches.empty())
+      Info->Branches[Block] = std::move(Branches);
+  }
+  return Info;
+}
+
+void DivergenceAnalyzer::reset(IdDependencyAnalyzer &IDDependencies) {
+  IDDepAnalyzer = &IDDependencies;
+  FunctionCache.clear();
+}
+
+const DivergenceAnalyzer::FunctionInfo &
+DivergenceAnalyzer::analyze(const FunctionDecl *Func, ASTContext &Context) {
+  if (const FunctionDecl *Definition = Func->getDefinition())
+    Func = Definition;
+  std::unique_ptr<FunctionInfo> &Cached = FunctionCache[Func];
+  if (!Cached)
+    Cached = analyzeImpl(Func, Context);
+  return *Cached;
+}
+
+const IdDependencyAnalyzer::FunctionInfo &
+DivergenceAnalyzer::analyzeIDDependency(const FunctionDecl *Func,
+                                        ASTContext &Context) {
+  assert(IDDepAnalyzer && "analyzer used before reset()");
+  return IDDepAnalyzer->analyze(Func, Context);
+}
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,107 @@
+//===--- DivergenceAnalyzer.h - clang-tidy ----------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_DIVERGENCE_ANALYZER_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_DIVERGENCE_ANALYZER_H
+
+#include "IdDependencyAnalyzer.h"
+#include "clang/AST/ParentMap.h"
+#include "clang/Analysis/CFG.h"
+#include "clang/Analysis/CFGStmtMap.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include <memory>
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+/// Computes which statements of an OpenCL function are executed by some
+/// work-items of a work-group but not by others.
+///
+/// The CFG of each function is built once, together with its post-dominator
+/// tree. A block is control dependent on a branch if it post-dominates one of
+/// its successors but not the branch itself; this covers early returns,
+/// ``break``, ``continue`` and ``goto`` as well as structured branches. A
+/// statement is in a divergent region if it is, directly or through other
+/// branches, control dependent on a branch whose condition depends on the
+/// work-item ID as computed by `IdDependencyAnalyzer`. Results are cached per
+/// `FunctionDecl`.
+///
+/// Each check owns its analyzer and resets it in
+/// ``onStartOfTranslationUnit()`` with the `IdDependencyAnalyzer` that the
+/// checks of the translation unit share.
+class DivergenceAnalyzer {
+public:
+  /// A branch whose condition depends on the work-item ID.
+  struct DivergentBranch {
+    /// The statement that branches: an ``if``, a loop, a ``switch``, a
+    /// conditional operator or a logical operator.
+    const Stmt *Control = nullptr;
+    /// The condition of `Control`.
+    const Expr *Condition = nullptr;
+    /// The sub-expression of `Condition` that depends on the work-item ID: a
+    /// call to an ID function, a reference to an ID-dependent variable or
+    /// field, or a call to a function returning an ID-dependent value.
+    const Expr *Cause = nullptr;
+  };
+
+  /// Divergence information for a single function.
+  class FunctionInfo {
+  public:
+    /// Returns the divergent branches that decide whether \p S is executed,
+    /// directly or through other branches, innermost first.
+    llvm::ArrayRef<DivergentBranch> getDivergentBranches(const Stmt *S) const;
+
+    bool isInDivergentRegion(const Stmt *S) const {
+      return !getDivergentBranches(S).empty();
+    }
+
+    /// Returns true if some statement of the function is in a divergent
+    /// region.
+    bool hasDivergentRegions() const { return !Branches.empty(); }
+
+  private:
+    friend class DivergenceAnalyzer;
+    std::unique_ptr<CFG> TheCFG;
+    std::unique_ptr<ParentMap> Parents;
+    std::unique_ptr<CFGStmtMap> StmtMap;
+    llvm::DenseMap<const CFGBlock *, llvm::SmallVector<DivergentBranch, 2>>
+        Branches;
+  };
+
+  DivergenceAnalyzer() = default;
+
+  /// Drops the cached results and starts over on a new translation unit,
+  /// whose ID-dependencies are computed by \p IDDependencies. Must be called
+  /// before the first query on each translation unit.
+  void reset(IdDependencyAnalyzer &IDDependencies);
+
+  /// Returns the divergence information of \p Func.
+  const FunctionInfo &analyze(const FunctionDecl *Func, ASTContext &Context);
+
+  /// Returns the ID-dependency information of \p Func that the divergence is
+  /// computed from.
+  const IdDependencyAnalyzer::FunctionInfo &
+  analyzeIDDependency(const FunctionDecl *Func, ASTContext &Context);
+
+private:
+  std::unique_ptr<FunctionInfo> analyzeImpl(const FunctionDecl *Func,
+                                            ASTContext &Context);
+
+  IdDependencyAnalyzer *IDDepAnalyzer = nullptr;
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<FunctionInfo>>
+      FunctionCache;
+};
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_DIVERGENCE_ANALYZER_H
@@ -0,0 +1,510 @@
+//===--- IdDependencyAnalyzer.cpp - clang-tidy ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "IdDependencyAnalyzer.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Analysis/CFG.h"
+#include "llvm/ADT/StringSwitch.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+namespace {
+
+/// Collects every function definition of a translation unit.
+class FunctionCollector : public RecursiveASTVisitor<FunctionCollector> {
+public:
+  bool VisitFunctionDecl(FunctionDecl *Func) {
+    if (Func->doesThisDeclarationHaveABody() && !Func->isDependentContext())
+      Functions.push_back(Func);
+    return true;
+  }
+
+  std::vector<const FunctionDecl *> Functions;
+};
+
+/// Returns true if an ID-dependent value stored to \p D by a function is
+/// visible to its callers.
+bool isExternalStore(const ValueDecl *D) {
+  if (isa<FieldDecl>(D))
+    return true;
+  if (isa<ParmVarDecl>(D))
+    return D->getType()->isPointerType() || D->getType()->isReferenceType();
+  if (const auto *Var = dyn_cast<VarDecl>(D))
+    return Var->hasGlobalStorage() && !Var->isStaticLocal();
+  return false;
+}
+
+/// Translates a store to \p D in the callee of \p Call into the declaration
+/// written in the caller.
+const ValueDecl *mapStoreToCaller(const ValueDecl *D, const CallExpr *Call) {
+  if (const auto *Param = dyn_cast<ParmVarDecl>(D)) {
+    unsigned Index = Param->getFunctionScopeIndex();
+    if (Index >= Call->getNumArgs())
+      return nullptr;
+    return IdDependencyAnalyzer::getAssignedDecl(Call->getArg(Index));
+  }
+  return D;
+}
+
+bool isIDFunctionCall(const CallExpr *Call) {
+  return IdDependencyAnalyzer::isIDFunction(Call->getDirectCallee());
+}
+
+} // namespace
+
+const IdDependencyAnalyzer::Dependency *
+IdDependencyAnalyzer::FunctionInfo::getDependency(const ValueDecl *D) const {
+  auto Found = Dependencies.find(D);
+  if (Found == Dependencies.end())
+    return nullptr;
+  return &Found->second;
+}
+
+const Expr *IdDependencyAnalyzer::FunctionInfo::findIDDependentReference(
+    const Expr *E) const {
+  if (!E)
+    return nullptr;
+  if (const auto *DeclRef = dyn_cast<DeclRefExpr>(E)) {
+    if (isa<VarDecl>(DeclRef->getDecl()) && isIDDependent(DeclRef->getDecl()))
+      return DeclRef;
+  } else if (const auto *Member = dyn_cast<MemberExpr>(E)) {
+    if (isIDDependent(Member->getMemberDecl()))
+      return Member;
+  }
+  for (const Stmt *Child : E->children()) {
+    if (const auto *ChildExpr = dyn_cast_or_null<Expr>(Child))
+      if (const Expr *Found = findIDDependentReference(ChildExpr))
+        return Found;
+  }
+  return nullptr;
+}
+
+const CallExpr *
+IdDependencyAnalyzer::FunctionInfo::findIDCall(const Expr *E) const {
+  if (!E)
+    return nullptr;
+  if (const auto *Call = dyn_cast<CallExpr>(E))
+    if (isIDFunctionCall(Call) || IDDependentCalls.count(Call))
+      return Call;
+  for (const Stmt *Child : E->children()) {
+    if (const auto *ChildExpr = dyn_cast_or_null<Expr>(Child))
+      if (const CallExpr *Found = findIDCall(ChildExpr))
+        return Found;
+  }
+  return nullptr;
+}
+
+bool IdDependencyAnalyzer::isIDFunction(const FunctionDecl *Func) {
+  if (!Func || !Func->getIdentifier())
+    return false;
+  return llvm::StringSwitch<bool>(Func->getName())
+      .Cases("get_global_id", "get_local_id", true)
+      .Default(false);
+}
+
+const CallExpr *IdDependencyAnalyzer::findIDFunctionCall(const Stmt *S) {
+  if (!S)
+    return nullptr;
+  if (const auto *Call = dyn_cast<CallExpr>(S))
+    if (isIDFunctionCall(Call))
+      return Call;
+  for (const Stmt *Child : S->children())
+    if (const CallExpr *Call = findIDFunctionCall(Child))
+      return Call;
+  return nullptr;
+}
+
+const ValueDecl *IdDependencyAnalyzer::getAssignedDecl(const Expr *E) {
+  while (E) {
+    E = E->IgnoreParenCasts();
+    if (const auto *DeclRef = dyn_cast<DeclRefExpr>(E))
+      return dyn_cast<VarDecl>(DeclRef->getDecl());
+    if (const auto *Member = dyn_cast<MemberExpr>(E))
+      return dyn_cast<FieldDecl>(Member->getMemberDecl());
+    if (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(E)) {
+      E = Subscript->getBase();
+      continue;
+    }
+    if (const auto *Unary = dyn_cast<UnaryOperator>(E)) {
+      if (Unary->getOpcode() != UO_Deref && Unary->getOpcode() != UO_AddrOf)
+        return nullptr;
+      E = Unary->getSubExpr();
+      continue;
+    }
+    return nullptr;
+  }
+  return nullptr;
+}
+
+void IdDependencyAnalyzer::collectSources(const Stmt *S, Transfer &T,
+                                          ASTContext &Context) {
+  if (!S)
+    return;
+  if (const auto *DeclRef = dyn_cast<DeclRefExpr>(S)) {
+    if (const auto *Var = dyn_cast<VarDecl>(DeclRef->getDecl()))
+      T.Sources.push_back(Var);
+  } else if (const auto *Member = dyn_cast<MemberExpr>(S)) {
+    if (const auto *Field = dyn_cast<FieldDecl>(Member->getMemberDecl()))
+      T.Sources.push_back(Field);
+  } else if (const auto *Call = dyn_cast<CallExpr>(S)) {
+    if (isIDFunctionCall(Call)) {
+      T.HasIDCall = true;
+      return;
+    }
+    // The result of a summarized call only depends on the arguments that
+    // flow into its return value.
+    if (const FunctionSummary *Summary =
+            getSummary(Call->getDirectCallee(), Context)) {
+      T.HasIDCall |= Summary->ReturnsIDDependent;
+      for (unsigned I = 0, E = Call->getNumArgs(); I != E; ++I)
+        if (I < Summary->ParamsToReturn.size() && Summary->ParamsToReturn[I])
+          collectSources(Call->getArg(I), T, Context);
+      return;
+    }
+  }
+  for (const Stmt *Child : S->children())
+    collectSources(Child, T, Context);
+}
+
+void IdDependencyAnalyzer::addTransfer(const ValueDecl *Target,
+                                       const Stmt *Origin, const Expr *Value,
+                                       FunctionData &Data,
+                                       ASTContext &Context) {
+  if (!Target || !Value)
+    return;
+  Transfer T{Target, Origin, false, {}};
+  collectSources(Value, T, Context);
+  Data.Transfers.push_back(std::move(T));
+
+  // Taking the address of a variable aliases it with the pointer, so a store
+  // through the pointer also makes the pointee ID-dependent.
+  const auto *AddrOf = dyn_cast<UnaryOperator>(Value->IgnoreParenImpCasts());
+  if (AddrOf && AddrOf->getOpcode() == UO_AddrOf) {
+    if (const ValueDecl *Pointee = getAssignedDecl(AddrOf->getSubExpr()))
+      Data.Transfers.push_back(Transfer{Pointee, Origin, false, {Target}});
+  }
+}
+
+void IdDependencyAnalyzer::collectTransfers(const Stmt *S,
+                                            const FunctionDecl *Func,
+                                            FunctionData &Data,
+                                            ASTContext &Context) {
+  if (const auto *Decls = dyn_cast<DeclStmt>(S)) {
+    for (const Decl *D : Decls->decls())
+      if (const auto *Var = dyn_cast<VarDecl>(D))
+        addTransfer(Var, Decls, Var->getInit(), Data, Context);
+    return;
+  }
+
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(S)) {
+    if (BinOp->isAssignmentOp())
+      addTransfer(getAssignedDecl(BinOp->getLHS()), BinOp, BinOp->getRHS(),
+                  Data, Context);
+    return;
+  }
+
+  // The function itself stands for its return value.
+  if (const auto *Return = dyn_cast<ReturnStmt>(S)) {
+    addTransfer(Func, Return, Return->getRetValue(), Data, Context);
+    return;
+  }
+
+  const auto *Call = dyn_cast<CallExpr>(S);
+  if (!Call || isIDFunctionCall(Call))
+    return;
+
+  if (const FunctionSummary *Summary =
+          getSummary(Call->getDirectCallee(), Context)) {
+    Data.Calls.push_back(Call);
+    Transfer Result{nullptr, Call, false, {}};
+    collectSources(Call, Result, Context);
+    Data.CallResults.push_back(std::move(Result));
+
+    // Replay the stores of the callee at the call site.
+    for (const ValueDecl *Store : Summary->IDDependentStores)
+      if (const ValueDecl *Target = mapStoreToCaller(Store, Call))
+        Data.Transfers.push_back(Transfer{Target, Call, true, {}});
+    for (unsigned I = 0, E = Call->getNumArgs(); I != E; ++I) {
+      if (I >= Summary->ParamStores.size())
+        break;
+      for (const ValueDecl *Store : Summary->ParamStores[I])
+        if (const ValueDecl *Target = mapStoreToCaller(Store, Call))
+          addTransfer(Target, Call, Call->getArg(I), Data, Context);
+    }
+    return;
+  }
+
+  // Without a definition, assume that a call whose arguments are ID-dependent
+  // may store an ID-dependent value through any pointer it is handed.
+  if (const FunctionDecl *Callee = Call->getDirectCallee())
+    if (Callee->hasBody())
+      Data.Calls.push_back(Call);
+  if (Call->getNumArgs() < 2)
+    return;
+  for (unsigned I = 0, E = Call->getNumArgs(); I != E; ++I) {
+    const Expr *Arg = Call->getArg(I)->IgnoreParenImpCasts();
+    if (!Arg->getType()->isPointerType())
+      continue;
+    const ValueDecl *Target = getAssignedDecl(Arg);
+    if (!Target)
+      continue;
+    Transfer T{Target, Call, false, {}};
+    for (unsigned J = 0; J != E; ++J)
+      if (J != I)
+        collectSources(Call->getArg(J), T, Context);
+    Data.Transfers.push_back(std::move(T));
+  }
+}
+
+const IdDependencyAnalyzer::FunctionData &
+IdDependencyAnalyzer::getFunctionData(const FunctionDecl *Func,
+                                      ASTContext &Context) {
+  auto Found = DataCache.find(Func);
+  if (Found != DataCache.end())
+    return *Found->second;
+
+  auto Data = std::make_unique<FunctionData>();
+  if (const Stmt *Body = Func->getBody()) {
+    // Gather the transfers of every statement reachable from the entry
+    // block. Every sub-expression is added to the CFG so that nested
+    // assignments and calls show up as elements of their own.
+    CFG::BuildOptions Options;
+    Options.setAllAlwaysAdd();
+    std::unique_ptr<CFG> TheCFG = CFG::buildCFG(
+        Func, const_cast<Stmt *>(Body), &Context, Options);
+    if (TheCFG) {
+      llvm::SmallPtrSet<const CFGBlock *, 32> Visited;
+      llvm::SmallVector<const CFGBlock *, 32> Blocks;
+      Blocks.push_back(&TheCFG->getEntry());
+      Visited.insert(&TheCFG->getEntry());
+      while (!Blocks.empty()) {
+        const CFGBlock *Block = Blocks.pop_back_val();
+        for (const CFGElement &Element : *Block)
+          if (Optional<CFGStmt> S = Element.getAs<CFGStmt>())
+            collectTransfers(S->getStmt(), Func, *Data, Context);
+        for (const CFGBlock *Succ : Block->succs())
+          if (Succ && Visited.insert(Succ).second)
+            Blocks.push_back(Succ);
+      }
+    } else {
+      // Fall back to a plain walk of the body if no CFG could be built.
+      llvm::SmallVector<const Stmt *, 32> Stmts{Body};
+      while (!Stmts.empty()) {
+        const Stmt *S = Stmts.pop_back_val();
+        collectTransfers(S, Func, *Data, Context);
+        for (const Stmt *Child : S->children())
+          if (Child)
+            Stmts.push_back(Child);
+      }
+    }
+  }
+
+  for (unsigned I = 0, E = Data->Transfers.size(); I != E; ++I)
+    for (const ValueDecl *Source : Data->Transfers[I].Sources)
+      Data->Users[Source].push_back(I);
+
+  // Summarizing a callee may have inserted into the cache, so look it up again.
+  std::unique_ptr<FunctionData> &Cached = DataCache[Func];
+  Cached = std::move(Data);
+  return *Cached;
+}
+
+void IdDependencyAnalyzer::propagate(
+    const FunctionData &Data,
+    llvm::ArrayRef<std::pair<const ValueDecl *, Dependency>> Seeds,
+    bool SeedIDCalls,
+    llvm::DenseMap<const ValueDecl *, Dependency> &Dependencies) {
+  llvm::SmallVector<const ValueDecl *, 32> Worklist;
+  for (const auto &Seed : Seeds)
+    if (Dependencies.insert(Seed).second)
+      Worklist.push_back(Seed.first);
+  if (SeedIDCalls) {
+    for (const Transfer &T : Data.Transfers)
+      if (T.HasIDCall &&
+          Dependencies.insert({T.Target, Dependency{T.Origin, nullptr}})
+              .second)
+        Worklist.push_back(T.Target);
+  }
+
+  // Dependencies only ever grow, so each declaration is pushed at most once.
+  for (unsigned Head = 0; Head != Worklist.size(); ++Head) {
+    const ValueDecl *Tainted = Worklist[Head];
+    auto Found = Data.Users.find(Tainted);
+    if (Found == Data.Users.end())
+      continue;
+    for (unsigned Index : Found->second) {
+      const Transfer &T = Data.Transfers[Index];
+      if (Dependencies.insert({T.Target, Dependency{T.Origin, Tainted}})
+              .second)
+        Worklist.push_back(T.Target);
+    }
+  }
+}
+
+const IdDependencyAnalyzer::FunctionSummary *
+IdDependencyAnalyzer::getSummary(const FunctionDecl *Func,
+                                 ASTContext &Context) {
+  if (!Func || isIDFunction(Func))
+    return nullptr;
+  const FunctionDecl *Definition = nullptr;
+  if (!Func->hasBody(Definition) || Definition->isDependentContext())
+    return nullptr;
+
+  // A null entry marks a summary that is being computed, i.e. recursion.
+  auto Found = SummaryCache.find(Definition);
+  if (Found != SummaryCache.end())
+    return Found->second.get();
+  SummaryCache[Definition] = nullptr;
+
+  const FunctionData &Data = getFunctionData(Definition, Context);
+  auto Summary = std::make_unique<FunctionSummary>();
+  auto CollectStores = [&](const llvm::DenseMap<const ValueDecl *,
+                                                Dependency> &Dependencies,
+                           const ValueDecl *Seed,
+                           llvm::SmallVectorImpl<const ValueDecl *> &Stores) {
+    llvm::SmallPtrSet<const ValueDecl *, 8> Seen;
+    for (const Transfer &T : Data.Transfers)
+      if (T.Target != Seed && isExternalStore(T.Target) &&
+          Dependencies.count(T.Target) && Seen.insert(T.Target).second)
+        Stores.push_back(T.Target);
+  };
+
+  llvm::DenseMap<const ValueDecl *, Dependency> Dependencies;
+  propagate(Data, {}, /*SeedIDCalls=*/true, Dependencies);
+  Summary->ReturnsIDDependent = Dependencies.count(Definition);
+  CollectStores(Dependencies, nullptr, Summary->IDDependentStores);
+
+  unsigned NumParams = Definition->getNumParams();
+  Summary->ParamsToReturn.resize(NumParams);
+  Summary->ParamStores.resize(NumParams);
+  for (unsigned I = 0; I != NumParams; ++I) {
+    const ParmVarDecl *Param = Definition->getParamDecl(I);
+    Dependencies.clear();
+    propagate(Data, {{Param, Dependency{}}}, /*SeedIDCalls=*/false,
+              Dependencies);
+    Summary->ParamsToReturn[I] = Dependencies.count(Definition);
+    CollectStores(Dependencies, Param, Summary->ParamStores[I]);
+  }
+
+  std::unique_ptr<FunctionSummary> &Cached = SummaryCache[Definition];
+  Cached = std::move(Summary);
+  return Cached.get();
+}
+
+std::unique_ptr<IdDependencyAnalyzer::FunctionInfo>
+IdDependencyAnalyzer::analyzeImpl(
+    const FunctionDecl *Func,
+    llvm::ArrayRef<std::pair<const ValueDecl *, Dependency>> Seeds,
+    ASTContext &Context) {
+  auto Info = std::make_unique<FunctionInfo>();
+  const FunctionData &Data = getFunctionData(Func, Context);
+  propagate(Data, Seeds, /*SeedIDCalls=*/true, Info->Dependencies);
+  for (const Transfer &Result : Data.CallResults) {
+    if (Result.HasIDCall ||
+        llvm::any_of(Result.Sources, [&](const ValueDecl *Source) {
+          return Info->isIDDependent(Source);
+        }))
+      Info->IDDependentCalls.insert(cast<CallExpr>(Result.Origin));
+  }
+  return Info;
+}
+
+void IdDependencyAnalyzer::analyzeTranslationUnit(ASTContext &Context) {
+  FunctionCollector Collector;
+  Collector.TraverseDecl(Context.getTranslationUnitDecl());
+
+  // Summarize bottom-up first, so that every function body is walked once.
+  for (const FunctionDecl *Func : Collector.Functions)
+    getSummary(Func, Context);
+
+  // Then push ID-dependent arguments and globals top-down until nothing
+  // changes. Seeds only ever grow, so this terminates.
+  llvm::DenseMap<const FunctionDecl *,
+                 llvm::SmallVector<std::pair<const ValueDecl *, Dependency>, 2>>
+      ParamSeeds;
+  llvm::SmallVector<std::pair<const ValueDecl *, Dependency>, 4> GlobalSeeds;
+  llvm::SmallPtrSet<const ValueDecl *, 4> SeededGlobals;
+  llvm::SmallVector<const FunctionDecl *, 32> Worklist(
+      Collector.Functions.begin(), Collector.Functions.end());
+  llvm::SmallPtrSet<const FunctionDecl *, 32> Queued(
+      Collector.Functions.begin(), Collector.Functions.end());
+
+  while (!Worklist.empty()) {
+    const FunctionDecl *Func = Worklist.pop_back_val();
+    Queued.erase(Func);
+
+    llvm::SmallVector<std::pair<const ValueDecl *, Dependency>, 8> Seeds(
+        GlobalSeeds.begin(), GlobalSeeds.end());
+    auto FoundSeeds = ParamSeeds.find(Func);
+    if (FoundSeeds != ParamSeeds.end())
+      Seeds.append(FoundSeeds->second.begin(), FoundSeeds->second.end());
+    std::unique_ptr<FunctionInfo> Info = analyzeImpl(Func, Seeds, Context);
+
+    for (const CallExpr *Call : getFunctionData(Func, Context).Calls) {
+      const FunctionDecl *Callee = nullptr;
+      if (!Call->getDirectCallee()->hasBody(Callee))
+        continue;
+      auto &CalleeSeeds = ParamSeeds[Callee];
+      bool Changed = false;
+      for (unsigned I = 0, E = std::min(Call->getNumArgs(),
+                                        Callee->getNumParams());
+           I != E; ++I) {
+        const ParmVarDecl *Param = Callee->getParamDecl(I);
+        if (!Info->isIDDependent(Call->getArg(I)) ||
+            llvm::any_of(CalleeSeeds, [&](const auto &Seed) {
+              return Seed.first == Param;
+            }))
+          continue;
+        Dependency Dep;
+        Dep.Origin = Call;
+        Dep.IsArgument = true;
+        CalleeSeeds.push_back({Param, Dep});
+        Changed = true;
+      }
+      if (Changed && Queued.insert(Callee).second)
+        Worklist.push_back(Callee);
+    }
+
+    bool GlobalsChanged = false;
+    for (const auto &Entry : Info->Dependencies) {
+      const auto *Var = dyn_cast<VarDecl>(Entry.first);
+      if (Var && isExternalStore(Var) && !isa<ParmVarDecl>(Var) &&
+          SeededGlobals.insert(Var).second) {
+        GlobalSeeds.push_back(Entry);
+        GlobalsChanged = true;
+      }
+    }
+    if (GlobalsChanged) {
+      for (const FunctionDecl *Other : Collector.Functions)
+        if (Other != Func && Queued.insert(Other).second)
+          Worklist.push_back(Other);
+    }
+
+    FunctionCache[Func] = std::move(Info);
+  }
+}
+
+const IdDependencyAnalyzer::FunctionInfo &
+IdDependencyAnalyzer::analyze(const FunctionDecl *Func, ASTContext &Context) {
+  if (!AnalyzedTranslationUnit) {
+    AnalyzedTranslationUnit = true;
+    analyzeTranslationUnit(Context);
+  }
+  if (const FunctionDecl *Definition = Func->getDefinition())
+    Func = Definition;
+  std::unique_ptr<FunctionInfo> &Cached = FunctionCache[Func];
+  if (!Cached)
+    Cached = analyzeImpl(Func, {}, Context);
+  return *Cached;
+}
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
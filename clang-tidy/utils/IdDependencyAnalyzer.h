@@ -0,0 +1,180 @@
+//===--- IdDependencyAnalyzer.h - clang-tidy --------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_ID_DEPENDENCY_ANALYZER_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_ID_DEPENDENCY_ANALYZER_H
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallBitVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include <memory>
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+/// Computes which variables and fields of an OpenCL function hold a value
+/// that depends on the work-item ID (i.e. on the result of ``get_global_id``
+/// or ``get_local_id``).
+///
+/// The CFG of each function is built once, every assignment, initialization
+/// and call reachable from the entry block is turned into a transfer from the
+/// referenced declarations to the assigned one, and the taint is then
+/// propagated with a worklist until a fixed point is reached. Results are
+/// cached per `FunctionDecl`, so repeated queries are O(1).
+///
+/// The analysis is interprocedural. A bottom-up `FunctionSummary` records how
+/// each function forwards ID-dependency from its parameters to its return
+/// value and to globals, fields and out-parameters, so call sites are handled
+/// without re-walking the callee. On the first query, all functions of the
+/// translation unit are then analyzed top-down so that parameters receiving
+/// ID-dependent arguments, and globals written with ID-dependent values, are
+/// ID-dependent in every function that reads them.
+class IdDependencyAnalyzer {
+public:
+  /// Describes why a declaration is ID-dependent.
+  struct Dependency {
+    /// The statement (declaration, assignment, return or call) that made the
+    /// declaration ID-dependent.
+    const Stmt *Origin = nullptr;
+    /// The ID-dependent declaration the value was inferred from, or nullptr if
+    /// it was assigned directly from an ID function call.
+    const ValueDecl *Source = nullptr;
+    /// True if the declaration is a parameter and `Origin` is a call site
+    /// that passes it an ID-dependent argument.
+    bool IsArgument = false;
+
+    bool isDirect() const { return Source == nullptr && !IsArgument; }
+  };
+
+  /// Describes how a function propagates ID-dependency to its callers.
+  struct FunctionSummary {
+    /// The function returns an ID-dependent value whatever its arguments are.
+    bool ReturnsIDDependent = false;
+    /// The parameters whose value flows into the return value.
+    llvm::SmallBitVector ParamsToReturn;
+    /// The globals, fields and pointer or reference parameters that are
+    /// written an ID-dependent value whatever the arguments are.
+    llvm::SmallVector<const ValueDecl *, 2> IDDependentStores;
+    /// For each parameter, the globals, fields and pointer or reference
+    /// parameters that its value is written to.
+    llvm::SmallVector<llvm::SmallVector<const ValueDecl *, 2>, 4> ParamStores;
+  };
+
+  /// ID-dependency information for a single function.
+  class FunctionInfo {
+  public:
+    /// Returns the dependency record of \p D, or nullptr if \p D is not
+    /// ID-dependent.
+    const Dependency *getDependency(const ValueDecl *D) const;
+
+    bool isIDDependent(const ValueDecl *D) const {
+      return getDependency(D) != nullptr;
+    }
+
+    /// Returns true if \p E calls an ID function or references an
+    /// ID-dependent variable or field.
+    bool isIDDependent(const Expr *E) const {
+      return findIDCall(E) || findIDDependentReference(E);
+    }
+
+    /// Returns the first (preorder) `DeclRefExpr` or `MemberExpr` in \p E
+    /// that references an ID-dependent variable or field, or nullptr.
+    const Expr *findIDDependentReference(const Expr *E) const;
+
+    /// Returns the first call in \p E to an ID function, or to a function
+    /// that returns an ID-dependent value for the given arguments, or nullptr.
+    const CallExpr *findIDCall(const Expr *E) const;
+
+  private:
+    friend class IdDependencyAnalyzer;
+    llvm::DenseMap<const ValueDecl *, Dependency> Dependencies;
+    llvm::SmallPtrSet<const CallExpr *, 8> IDDependentCalls;
+  };
+
+  IdDependencyAnalyzer() = default;
+
+  /// Returns the ID-dependency information of \p Func. The whole translation
+  /// unit is analyzed on the first request.
+  const FunctionInfo &analyze(const FunctionDecl *Func, ASTContext &Context);
+
+  /// Returns the summary of \p Func, or nullptr if it has no definition or is
+  /// part of a recursive cycle that is still being summarized.
+  const FunctionSummary *getSummary(const FunctionDecl *Func,
+                                    ASTContext &Context);
+
+  /// Returns true if \p Func is one of the work-item ID functions.
+  static bool isIDFunction(const FunctionDecl *Func);
+
+  /// Returns the first (preorder) call to an ID function within \p S, or
+  /// nullptr.
+  static const CallExpr *findIDFunctionCall(const Stmt *S);
+
+  /// Returns the variable or field that an assignment to \p E writes to,
+  /// looking through parentheses, casts, dereferences and subscripts. Returns
+  /// nullptr if it cannot be determined.
+  static const ValueDecl *getAssignedDecl(const Expr *E);
+
+private:
+  /// A flow of values from the declarations in `Sources` (or an ID function
+  /// call) into `Target`.
+  struct Transfer {
+    const ValueDecl *Target;
+    const Stmt *Origin;
+    bool HasIDCall;
+    llvm::SmallVector<const ValueDecl *, 4> Sources;
+  };
+
+  /// The transfers of a single function, collected once from its CFG.
+  struct FunctionData {
+    /// Assignments, returns (whose target is the function itself) and the
+    /// effects of calls.
+    std::vector<Transfer> Transfers;
+    /// Maps each declaration to the transfers reading it.
+    llvm::DenseMap<const ValueDecl *, llvm::SmallVector<unsigned, 4>> Users;
+    /// Calls to summarized functions, with their result as the "target".
+    std::vector<Transfer> CallResults;
+    /// Calls to functions defined in this translation unit.
+    std::vector<const CallExpr *> Calls;
+  };
+
+  const FunctionData &getFunctionData(const FunctionDecl *Func,
+                                      ASTContext &Context);
+  void collectTransfers(const Stmt *S, const FunctionDecl *Func,
+                        FunctionData &Data, ASTContext &Context);
+  void collectSources(const Stmt *S, Transfer &T, ASTContext &Context);
+  void addTransfer(const ValueDecl *Target, const Stmt *Origin,
+                   const Expr *Value, FunctionData &Data, ASTContext &Context);
+  void propagate(const FunctionData &Data,
+                 llvm::ArrayRef<std::pair<const ValueDecl *, Dependency>> Seeds,
+                 bool SeedIDCalls,
+                 llvm::DenseMap<const ValueDecl *, Dependency> &Dependencies);
+  std::unique_ptr<FunctionInfo>
+  analyzeImpl(const FunctionDecl *Func,
+              llvm::ArrayRef<std::pair<const ValueDecl *, Dependency>> Seeds,
+              ASTContext &Context);
+  void analyzeTranslationUnit(ASTContext &Context);
+
+  bool AnalyzedTranslationUnit = false;
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<FunctionData>>
+      DataCache;
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<FunctionSummary>>
+      SummaryCache;
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<FunctionInfo>>
+      FunctionCache;
+};
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_ID_DEPENDENCY_ANALYZER_H
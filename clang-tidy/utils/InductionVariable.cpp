@@ -0,0 +1,425 @@
+//===--- InductionVariable.cpp - clang-tidy -------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "InductionVariable.h"
+#include "llvm/Support/CheckedArithmetic.h"
+#include <limits>
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+namespace {
+
+const unsigned MaxConstantDepth = 8;
+
+llvm::Optional<int64_t> evaluateIntegerImpl(const Expr *E,
+                                            const ASTContext &Context,
+                                            unsigned Depth) {
+  if (!E || E->isValueDependent() || E->isTypeDependent())
+    return llvm::None;
+  Expr::EvalResult Result;
+  if (E->EvaluateAsInt(Result, Context)) {
+    const llvm::APSInt &Value = Result.Val.getInt();
+    if (!Value.isRepresentableByInt64())
+      return llvm::None;
+    return Value.getExtValue();
+  }
+  // In C, a const-qualified variable is not a constant expression, but its
+  // value is still known if it has a constant initializer.
+  const auto *Ref = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts());
+  if (!Ref || Depth == MaxConstantDepth)
+    return llvm::None;
+  const auto *Var = dyn_cast<VarDecl>(Ref->getDecl());
+  if (!Var || !Var->getType().isConstQualified() || !Var->getInit())
+    return llvm::None;
+  return evaluateIntegerImpl(Var->getInit(), Context, Depth + 1);
+}
+
+const VarDecl *getReferencedVar(const Expr *E) {
+  if (!E)
+    return nullptr;
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts()))
+    return dyn_cast<VarDecl>(Ref->getDecl());
+  return nullptr;
+}
+
+bool referencesVar(const Stmt *S, const VarDecl *Var) {
+  if (!S)
+    return false;
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(S))
+    if (Ref->getDecl() == Var)
+      return true;
+  for (const Stmt *Child : S->children())
+    if (referencesVar(Child, Var))
+      return true;
+  return false;
+}
+
+/// Returns the constant amount by which \p Update changes \p Var.
+llvm::Optional<int64_t> getStep(const Stmt *Update, const VarDecl *Var,
+                                const ASTContext &Context) {
+  const auto *E = dyn_cast_or_null<Expr>(Update);
+  if (!E)
+    return llvm::None;
+  E = E->IgnoreParenImpCasts();
+  if (const auto *Unary = dyn_cast<UnaryOperator>(E)) {
+    if (getReferencedVar(Unary->getSubExpr()) != Var)
+      return llvm::None;
+    if (Unary->isIncrementOp())
+      return 1;
+    if (Unary->isDecrementOp())
+      return -1;
+    return llvm::None;
+  }
+  const auto *BinOp = dyn_cast<BinaryOperator>(E);
+  if (!BinOp || getReferencedVar(BinOp->getLHS()) != Var)
+    return llvm::None;
+  switch (BinOp->getOpcode()) {
+  case BO_AddAssign:
+    return evaluateInteger(BinOp->getRHS(), Context);
+  case BO_SubAssign:
+    if (llvm::Optional<int64_t> Step =
+            evaluateInteger(BinOp->getRHS(), Context))
+      return llvm::checkedSub<int64_t>(0, *Step);
+    return llvm::None;
+  case BO_Assign: {
+    // Var = Var + C, Var = C + Var or Var = Var - C
+    const auto *RHS =
+        dyn_cast<BinaryOperator>(BinOp->getRHS()->IgnoreParenImpCasts());
+    if (!RHS)
+      return llvm::None;
+    if (RHS->getOpcode() == BO_Add) {
+      if (getReferencedVar(RHS->getLHS()) == Var)
+        return evaluateInteger(RHS->getRHS(), Context);
+      if (getReferencedVar(RHS->getRHS()) == Var)
+        return evaluateInteger(RHS->getLHS(), Context);
+    } else if (RHS->getOpcode() == BO_Sub &&
+               getReferencedVar(RHS->getLHS()) == Var) {
+      if (llvm::Optional<int64_t> Step =
+              evaluateInteger(RHS->getRHS(), Context))
+        return llvm::checkedSub<int64_t>(0, *Step);
+    }
+    return llvm::None;
+  }
+  default:
+    return llvm::None;
+  }
+}
+
+/// Collects every statement within \p S that may modify \p Var.
+void collectUpdates(const Stmt *S, const VarDecl *Var,
+                    llvm::SmallVectorImpl<const Stmt *> &Updates) {
+  if (!S)
+    return;
+  if (const auto *Unary = dyn_cast<UnaryOperator>(S)) {
+    if ((Unary->isIncrementDecrementOp() ||
+         Unary->getOpcode() == UO_AddrOf) &&
+        getReferencedVar(Unary->getSubExpr()) == Var)
+      Updates.push_back(S);
+  } else if (const auto *BinOp = dyn_cast<BinaryOperator>(S)) {
+    if (BinOp->isAssignmentOp() && getReferencedVar(BinOp->getLHS()) == Var)
+      Updates.push_back(S);
+  }
+  for (const Stmt *Child : S->children())
+    collectUpdates(Child, Var, Updates);
+}
+
+/// Returns true if \p S contains a continue statement that applies to the
+/// loop \p S is the body of.
+bool hasContinue(const Stmt *S) {
+  if (!S)
+    return false;
+  if (isa<ContinueStmt>(S))
+    return true;
+  if (isa<ForStmt>(S) || isa<WhileStmt>(S) || isa<DoStmt>(S))
+    return false;
+  for (const Stmt *Child : S->children())
+    if (hasContinue(Child))
+      return true;
+  return false;
+}
+
+/// Returns the value \p Var holds when \p Loop is entered, looking backwards
+/// through the statements that precede the loop in its compound statement.
+llvm::Optional<int64_t> getInitialValue(const Stmt *Loop, const VarDecl *Var,
+                                        ASTContext &Context) {
+  const Stmt *Current = Loop;
+  const CompoundStmt *Parent = nullptr;
+  while (!Parent) {
+    const auto Parents = Context.getParents(*Current);
+    if (Parents.empty())
+      return llvm::None;
+    if (const auto *Attributed = Parents[0].get<AttributedStmt>())
+      Current = Attributed;
+    else if (!(Parent = Parents[0].get<CompoundStmt>()))
+      return llvm::None;
+  }
+
+  auto Position = std::find(Parent->body_begin(), Parent->body_end(), Current);
+  while (Position != Parent->body_begin()) {
+    const Stmt *Previous = *--Position;
+    if (const auto *Decls = dyn_cast<DeclStmt>(Previous)) {
+      for (const Decl *D : Decls->decls())
+        if (D == Var)
+          return evaluateInteger(Var->getInit(), Context);
+    } else if (const auto *BinOp = dyn_cast<BinaryOperator>(Previous)) {
+      if (BinOp->getOpcode() == BO_Assign &&
+          getReferencedVar(BinOp->getLHS()) == Var)
+        return evaluateInteger(BinOp->getRHS(), Context);
+    }
+    if (referencesVar(Previous, Var))
+      return llvm::None;
+  }
+  return llvm::None;
+}
+
+/// Recognizes "Var op Bound" or "Bound op Var" and normalizes it to the
+/// former.
+bool matchCondition(const Expr *Cond, const ASTContext &Context,
+                    InductionLoop &Result) {
+  const auto *BinOp =
+      dyn_cast_or_null<BinaryOperator>(Cond ? Cond->IgnoreParenImpCasts()
+                                            : nullptr);
+  if (!BinOp)
+    return false;
+  BinaryOperatorKind Opcode = BinOp->getOpcode();
+  if (Opcode != BO_LT && Opcode != BO_LE && Opcode != BO_GT &&
+      Opcode != BO_GE && Opcode != BO_NE)
+    return false;
+
+  if (const VarDecl *Var = getReferencedVar(BinOp->getLHS())) {
+    if (llvm::Optional<int64_t> Bound =
+            evaluateInteger(BinOp->getRHS(), Context)) {
+      Result.Var = Var;
+      Result.Bound = *Bound;
+      Result.Opcode = Opcode;
+      return true;
+    }
+  }
+  if (const VarDecl *Var = getReferencedVar(BinOp->getRHS())) {
+    if (llvm::Optional<int64_t> Bound =
+            evaluateInteger(BinOp->getLHS(), Context)) {
+      Result.Var = Var;
+      Result.Bound = *Bound;
+      Result.Opcode = BinaryOperator::reverseComparisonOp(Opcode);
+      return true;
+    }
+  }
+  return false;
+}
+
+llvm::Optional<uint64_t> countIterations(int64_t Init, int64_t Step,
+                                         int64_t Bound,
+                                         BinaryOperatorKind Opcode) {
+  // Neither difference is INT64_MIN once both are known, so they can be
+  // negated, and the step is rejected if it cannot be.
+  llvm::Optional<int64_t> Up = llvm::checkedSub(Bound, Init);
+  llvm::Optional<int64_t> Down = llvm::checkedSub(Init, Bound);
+  if (!Up || !Down || Step == std::numeric_limits<int64_t>::min())
+    return llvm::None;
+  switch (Opcode) {
+  case BO_LT:
+    if (Init >= Bound)
+      return 0;
+    if (Step <= 0)
+      return llvm::None;
+    return static_cast<uint64_t>((*Up - 1) / Step) + 1;
+  case BO_LE:
+    if (Init > Bound)
+      return 0;
+    if (Step <= 0)
+      return llvm::None;
+    return static_cast<uint64_t>(*Up / Step) + 1;
+  case BO_GT:
+    if (Init <= Bound)
+      return 0;
+    if (Step >= 0)
+      return llvm::None;
+    return static_cast<uint64_t>((*Down - 1) / -Step) + 1;
+  case BO_GE:
+    if (Init < Bound)
+      return 0;
+    if (Step >= 0)
+      return llvm::None;
+    return static_cast<uint64_t>(*Down / -Step) + 1;
+  case BO_NE:
+    if (Init == Bound)
+      return 0;
+    if (Step == 0 || *Up % Step != 0 || *Up / Step < 0)
+      return llvm::None;
+    return *Up / Step;
+  default:
+    return llvm::None;
+  }
+}
+
+} // namespace
+
+llvm::Optional<int64_t> evaluateInteger(const Expr *E,
+                                        const ASTContext &Context) {
+  return evaluateIntegerImpl(E, Context, 0);
+}
+
+llvm::Optional<InductionLoop> getInductionLoop(const Stmt *Loop,
+                                               ASTContext &Context) {
+  InductionLoop Result;
+  if (const auto *For = dyn_cast<ForStmt>(Loop)) {
+    if (!matchCondition(For->getCond(), Context, Result))
+      return llvm::None;
+    llvm::Optional<int64_t> Step = getStep(For->getInc(), Result.Var, Context);
+    if (!Step)
+      return llvm::None;
+    Result.Step = *Step;
+
+    llvm::SmallVector<const Stmt *, 2> Updates;
+    collectUpdates(For->getBody(), Result.Var, Updates);
+    if (!Updates.empty())
+      return llvm::None;
+
+    llvm::Optional<int64_t> Init;
+    const Stmt *InitStmt = For->getInit();
+    if (!InitStmt) {
+      Init = getInitialValue(For, Result.Var, Context);
+    } else if (const auto *Decls = dyn_cast<DeclStmt>(InitStmt)) {
+      for (const Decl *D : Decls->decls())
+        if (D == Result.Var)
+          Init = evaluateInteger(Result.Var->getInit(), Context);
+    } else if (const auto *BinOp = dyn_cast<BinaryOperator>(InitStmt)) {
+      if (BinOp->getOpcode() == BO_Assign &&
+          getReferencedVar(BinOp->getLHS()) == Result.Var)
+        Init = evaluateInteger(BinOp->getRHS(), Context);
+    }
+    if (!Init)
+      return llvm::None;
+    Result.Init = *Init;
+    return Result;
+  }
+
+  const Expr *Cond = nullptr;
+  const Stmt *Body = nullptr;
+  if (const auto *While = dyn_cast<WhileStmt>(Loop)) {
+    Cond = While->getCond();
+    Body = While->getBody();
+  } else if (const auto *Do = dyn_cast<DoStmt>(Loop)) {
+    Cond = Do->getCond();
+    Body = Do->getBody();
+    Result.IsDoWhile = true;
+  } else {
+    return llvm::None;
+  }
+  if (!matchCondition(Cond, Context, Result) || hasContinue(Body))
+    return llvm::None;
+
+  // The variable must be updated exactly once per iteration, by a statement
+  // that is executed unconditionally.
+  llvm::SmallVector<const Stmt *, 2> Updates;
+  collectUpdates(Body, Result.Var, Updates);
+  if (Updates.size() != 1)
+    return llvm::None;
+  const auto *Compound = dyn_cast<CompoundStmt>(Body);
+  if (Compound ? std::find(Compound->body_begin(), Compound->body_end(),
+                           Updates.front()) == Compound->body_end()
+               : Body != Updates.front())
+    return llvm::None;
+  llvm::Optional<int64_t> Step = getStep(Updates.front(), Result.Var, Context);
+  llvm::Optional<int64_t> Init = getInitialValue(Loop, Result.Var, Context);
+  if (!Step || !Init)
+    return llvm::None;
+  Result.Step = *Step;
+  Result.Init = *Init;
+  return Result;
+}
+
+llvm::Optional<InductionVariable> getInductionVariable(const Stmt *Loop,
+                                                       ASTContext &Context) {
+  InductionVariable Result;
+  if (const auto *For = dyn_cast<ForStmt>(Loop)) {
+    const auto *Inc = dyn_cast_or_null<Expr>(For->getInc());
+    if (!Inc)
+      return llvm::None;
+    Inc = Inc->IgnoreParenImpCasts();
+    if (const auto *Unary = dyn_cast<UnaryOperator>(Inc))
+      Result.Var = getReferencedVar(Unary->getSubExpr());
+    else if (const auto *BinOp = dyn_cast<BinaryOperator>(Inc))
+      Result.Var = getReferencedVar(BinOp->getLHS());
+    if (!Result.Var)
+      return llvm::None;
+    llvm::Optional<int64_t> Step = getStep(Inc, Result.Var, Context);
+    llvm::SmallVector<const Stmt *, 2> Updates;
+    collectUpdates(For->getBody(), Result.Var, Updates);
+    if (!Step || !Updates.empty())
+      return llvm::None;
+    Result.Step = *Step;
+    return Result;
+  }
+
+  const Expr *Cond = nullptr;
+  const Stmt *Body = nullptr;
+  if (const auto *While = dyn_cast<WhileStmt>(Loop)) {
+    Cond = While->getCond();
+    Body = While->getBody();
+  } else if (const auto *Do = dyn_cast<DoStmt>(Loop)) {
+    Cond = Do->getCond();
+    Body = Do->getBody();
+  }
+  const auto *BinOp =
+      dyn_cast_or_null<BinaryOperator>(Cond ? Cond->IgnoreParenImpCasts()
+                                            : nullptr);
+  if (!BinOp || !BinOp->isComparisonOp() || hasContinue(Body))
+    return llvm::None;
+  const auto *Compound = dyn_cast<CompoundStmt>(Body);
+  for (const Expr *Side : {BinOp->getLHS(), BinOp->getRHS()}) {
+    const VarDecl *Var = getReferencedVar(Side);
+    if (!Var)
+      continue;
+    llvm::SmallVector<const Stmt *, 2> Updates;
+    collectUpdates(Body, Var, Updates);
+    if (Updates.size() != 1)
+      continue;
+    if (Compound ? std::find(Compound->body_begin(), Compound->body_end(),
+                             Updates.front()) == Compound->body_end()
+                 : Body != Updates.front())
+      continue;
+    if (llvm::Optional<int64_t> Step = getStep(Updates.front(), Var, Context)) {
+      Result.Var = Var;
+      Result.Step = *Step;
+      return Result;
+    }
+  }
+  return llvm::None;
+}
+
+llvm::Optional<uint64_t> getTripCount(const InductionLoop &Loop) {
+  int64_t Init = Loop.Init;
+  uint64_t FirstIteration = 0;
+  if (Loop.IsDoWhile) {
+    // The body runs once before the condition is first checked.
+    llvm::Optional<int64_t> Next = llvm::checkedAdd(Init, Loop.Step);
+    if (!Next)
+      return llvm::None;
+    Init = *Next;
+    FirstIteration = 1;
+  }
+  llvm::Optional<uint64_t> Count =
+      countIterations(Init, Loop.Step, Loop.Bound, Loop.Opcode);
+  if (!Count)
+    return llvm::None;
+  return *Count + FirstIteration;
+}
+
+llvm::Optional<uint64_t> getTripCount(const Stmt *Loop, ASTContext &Context) {
+  if (llvm::Optional<InductionLoop> Induction =
+          getInductionLoop(Loop, Context))
+    return getTripCount(*Induction);
+  return llvm::None;
+}
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
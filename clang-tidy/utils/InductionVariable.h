@@ -0,0 +1,79 @@
+//===--- InductionVariable.h - clang-tidy -----------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_INDUCTION_VARIABLE_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_INDUCTION_VARIABLE_H
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Stmt.h"
+#include "llvm/ADT/Optional.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+/// A loop controlled by a single induction variable that starts at a constant,
+/// moves by a constant step on every iteration, and is compared against a
+/// constant bound.
+struct InductionLoop {
+  const VarDecl *Var = nullptr;
+  int64_t Init = 0;
+  int64_t Step = 0;
+  int64_t Bound = 0;
+  /// The comparison, normalized so that the induction variable is on the
+  /// left-hand side: one of <, <=, >, >= or !=.
+  BinaryOperatorKind Opcode = BO_LT;
+  /// The condition is only evaluated after the first iteration (do..while).
+  bool IsDoWhile = false;
+};
+
+/// The induction variable of a loop and the constant amount by which it
+/// changes on every iteration. Its initial value and bound need not be known.
+struct InductionVariable {
+  const VarDecl *Var = nullptr;
+  int64_t Step = 0;
+};
+
+/// Evaluates \p E to an integer constant. Besides what the constant evaluator
+/// folds (including macros and constexpr variables), this also looks through
+/// const-qualified variables with a constant initializer, which are not
+/// constant expressions in C.
+llvm::Optional<int64_t> evaluateInteger(const Expr *E,
+                                        const ASTContext &Context);
+
+/// Recognizes the induction variable of a for, while or do..while loop.
+///
+/// The initial value is taken from the init-statement of a for loop, or from
+/// the closest preceding statement in the enclosing compound statement that
+/// declares or assigns the variable. The step is taken from the increment of a
+/// for loop, or from the single unconditional update in the body of a while or
+/// do..while loop. Returns None if any of these is not a constant, or if the
+/// variable is modified anywhere else in the loop.
+llvm::Optional<InductionLoop> getInductionLoop(const Stmt *Loop,
+                                               ASTContext &Context);
+
+/// Recognizes the induction variable of a for, while or do..while loop that
+/// is compared against an arbitrary expression, such as a kernel argument.
+/// The variable must be updated by a constant step exactly once per iteration,
+/// as for getInductionLoop().
+llvm::Optional<InductionVariable> getInductionVariable(const Stmt *Loop,
+                                                       ASTContext &Context);
+
+/// Returns the exact number of iterations of \p Loop, or None if the loop
+/// does not terminate.
+llvm::Optional<uint64_t> getTripCount(const InductionLoop &Loop);
+
+/// Returns the exact number of iterations of \p Loop, or None if it cannot be
+/// computed.
+llvm::Optional<uint64_t> getTripCount(const Stmt *Loop, ASTContext &Context);
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_INDUCTION_VARIABLE_H
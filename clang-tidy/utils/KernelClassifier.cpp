@@ -0,0 +1,168 @@
+//===--- KernelClassifier.cpp - clang-tidy --------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "KernelClassifier.h"
+#include "InductionVariable.h"
+#include "clang/AST/Attr.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringSwitch.h"
+#include <functional>
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+namespace {
+
+/// Returns true if \p Func returns the shape of the NDRange rather than the
+/// position of the work-item, which does not depend on the work-item.
+bool isSizeQueryFunction(const FunctionDecl *Func) {
+  if (!Func || !Func->getIdentifier())
+    return false;
+  return llvm::StringSwitch<bool>(Func->getName())
+      .Cases("get_global_size", "get_local_size", "get_enqueued_local_size",
+             "get_num_groups", "get_work_dim", true)
+      .Default(false);
+}
+
+bool isLocalMemory(QualType Type) {
+  if (Type.getAddressSpace() == LangAS::opencl_local)
+    return true;
+  if (const auto *Pointer = Type->getAs<PointerType>())
+    return Pointer->getPointeeType().getAddressSpace() == LangAS::opencl_local;
+  return false;
+}
+
+} // namespace
+
+bool KernelClassifier::KernelInfo::isTrivialNDRange(
+    const ASTContext &Context) const {
+  if (Model != NDRange || HasWorkGroupSize || UsesLocalMemory ||
+      !SizeQueries.empty() || !Barriers.empty())
+    return false;
+  for (const CallExpr *Call : IDCalls) {
+    if (Call->getDirectCallee()->getName() != "get_global_id" ||
+        Call->getNumArgs() != 1)
+      return false;
+    const llvm::Optional<int64_t> Dimension =
+        evaluateInteger(Call->getArg(0), Context);
+    if (!Dimension || *Dimension != 0)
+      return false;
+  }
+  return true;
+}
+
+bool KernelClassifier::isWorkItemIDFunction(const FunctionDecl *Func) {
+  if (!Func || !Func->getIdentifier())
+    return false;
+  return llvm::StringSwitch<bool>(Func->getName())
+      .Cases("get_global_id", "get_local_id", "get_group_id",
+             "get_global_offset", true)
+      .Cases("get_global_linear_id", "get_local_linear_id", true)
+      .Default(false);
+}
+
+bool KernelClassifier::isBarrierFunction(const FunctionDecl *Func) {
+  if (!Func || !Func->getIdentifier())
+    return false;
+  return Func->getName() == "barrier" ||
+         Func->getName() == "work_group_barrier";
+}
+
+const KernelClassifier::FunctionFacts &
+KernelClassifier::getFacts(const FunctionDecl *Func) {
+  std::unique_ptr<FunctionFacts> &Cached = FactsCache[Func];
+  if (Cached)
+    return *Cached;
+  Cached = std::make_unique<FunctionFacts>();
+  FunctionFacts &Facts = *Cached;
+
+  for (const ParmVarDecl *Param : Func->parameters())
+    if (isLocalMemory(Param->getType()))
+      Facts.UsesLocalMemory = true;
+
+  std::function<void(const Stmt *)> Collect = [&](const Stmt *S) {
+    if (!S)
+      return;
+    if (const auto *Call = dyn_cast<CallExpr>(S)) {
+      const FunctionDecl *Callee = Call->getDirectCallee();
+      if (isWorkItemIDFunction(Callee))
+        Facts.IDCalls.push_back(Call);
+      else if (isSizeQueryFunction(Callee))
+        Facts.SizeQueries.push_back(Call);
+      else if (isBarrierFunction(Callee))
+        Facts.Barriers.push_back(Call);
+    } else if (const auto *DeclS = dyn_cast<DeclStmt>(S)) {
+      for (const Decl *D : DeclS->decls())
+        if (const auto *Var = dyn_cast<VarDecl>(D))
+          if (isLocalMemory(Var->getType()))
+            Facts.UsesLocalMemory = true;
+    }
+    for (const Stmt *Child : S->children())
+      Collect(Child);
+  };
+  Collect(Func->getBody());
+  return Facts;
+}
+
+const KernelClassifier::KernelInfo &
+KernelClassifier::classify(const FunctionDecl *Kernel, ASTContext &Context) {
+  // A classifier is only ever used on a single translation unit: checks are
+  // created per translation unit and share the classifier through their
+  // ClangTidyContext, which drops it before the next one starts.
+  if (!Graph) {
+    Graph = std::make_unique<CallGraph>();
+    Graph->addToCallGraph(Context.getTranslationUnitDecl());
+  }
+  if (const FunctionDecl *Definition = Kernel->getDefinition())
+    Kernel = Definition;
+  std::unique_ptr<KernelInfo> &Cached = KernelCache[Kernel];
+  if (Cached)
+    return *Cached;
+  Cached = std::make_unique<KernelInfo>();
+  KernelInfo &Info = *Cached;
+
+  if (const auto *Size = Kernel->getAttr<ReqdWorkGroupSizeAttr>())
+    Info.HasWorkGroupSize =
+        Size->getXDim() > 1 || Size->getYDim() > 1 || Size->getZDim() > 1;
+
+  // Walk the functions reachable from the kernel in depth-first preorder, so
+  // that the calls in the kernel itself come first.
+  llvm::SmallPtrSet<const FunctionDecl *, 8> Visited;
+  llvm::SmallVector<const FunctionDecl *, 8> Worklist{Kernel};
+  while (!Worklist.empty()) {
+    const FunctionDecl *Func = Worklist.pop_back_val();
+    if (!Visited.insert(Func).second)
+      continue;
+    const FunctionFacts &Facts = getFacts(Func);
+    Info.IDCalls.append(Facts.IDCalls.begin(), Facts.IDCalls.end());
+    Info.SizeQueries.append(Facts.SizeQueries.begin(), Facts.SizeQueries.end());
+    Info.Barriers.append(Facts.Barriers.begin(), Facts.Barriers.end());
+    Info.UsesLocalMemory |= Facts.UsesLocalMemory;
+
+    const CallGraphNode *Node = Graph->getNode(Func->getCanonicalDecl());
+    if (!Node)
+      continue;
+    llvm::SmallVector<const FunctionDecl *, 4> Callees;
+    for (const CallGraphNode *Callee : *Node) {
+      const auto *CalleeDecl = dyn_cast_or_null<FunctionDecl>(Callee->getDecl());
+      const FunctionDecl *Definition = nullptr;
+      if (CalleeDecl && CalleeDecl->hasBody(Definition))
+        Callees.push_back(Definition);
+    }
+    Worklist.append(Callees.rbegin(), Callees.rend());
+  }
+
+  if (!Info.IDCalls.empty() || Info.HasWorkGroupSize)
+    Info.Model = NDRange;
+  return Info;
+}
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,101 @@
+//===--- KernelClassifier.h - clang-tidy ------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_KERNEL_CLASSIFIER_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_KERNEL_CLASSIFIER_H
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+#include "clang/Analysis/CallGraph.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include <memory>
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+/// Classifies OpenCL kernels as single-work-item or NDRange kernels, the way
+/// the Intel FPGA SDK for OpenCL offline compiler does: a kernel is an NDRange
+/// kernel if it, or a function it calls, asks for the position of the
+/// work-item with ``get_global_id``, ``get_local_id``, ``get_group_id``,
+/// ``get_global_offset`` or their linear variants, or if its
+/// ``reqd_work_group_size`` attribute asks for more than one work-item.
+///
+/// The call graph of the translation unit is built on the first query and the
+/// work-item function calls, barriers and local memory of each function are
+/// collected once, so each kernel is classified by a single walk of the
+/// functions it reaches. Results are cached per kernel.
+///
+/// A classifier must not outlive its translation unit. Checks share a single
+/// instance per translation unit through
+/// ``ClangTidyCheck::getTranslationUnitAnalysis<KernelClassifier>()``.
+class KernelClassifier {
+public:
+  enum ExecutionModel { SingleWorkItem, NDRange };
+
+  /// What a kernel and the functions it calls do with the NDRange.
+  struct KernelInfo {
+    ExecutionModel Model = SingleWorkItem;
+    /// The calls to work-item ID functions, in the kernel first and then in
+    /// the functions it calls.
+    llvm::SmallVector<const CallExpr *, 4> IDCalls;
+    /// The calls to functions that query the shape of the NDRange, such as
+    /// ``get_global_size``.
+    llvm::SmallVector<const CallExpr *, 2> SizeQueries;
+    /// The calls to ``barrier`` and ``work_group_barrier``.
+    llvm::SmallVector<const CallExpr *, 2> Barriers;
+    /// True if a ``__local`` variable or parameter is used.
+    bool UsesLocalMemory = false;
+    /// True if the kernel has a ``reqd_work_group_size`` attribute other than
+    /// (1, 1, 1).
+    bool HasWorkGroupSize = false;
+
+    /// Returns true if the kernel is an NDRange kernel only because it reads
+    /// ``get_global_id(0)``, so that it could be written as a single-work-item
+    /// kernel with a loop over the work-items instead.
+    bool isTrivialNDRange(const ASTContext &Context) const;
+  };
+
+  KernelClassifier() = default;
+
+  /// Returns the classification of \p Kernel. The call graph of the
+  /// translation unit is built on the first request.
+  const KernelInfo &classify(const FunctionDecl *Kernel, ASTContext &Context);
+
+  /// Returns true if \p Func returns the position of the work-item in the
+  /// NDRange, which makes a kernel calling it an NDRange kernel.
+  static bool isWorkItemIDFunction(const FunctionDecl *Func);
+
+  /// Returns true if \p Func is a work-group barrier.
+  static bool isBarrierFunction(const FunctionDecl *Func);
+
+private:
+  /// The relevant calls and declarations of a single function.
+  struct FunctionFacts {
+    llvm::SmallVector<const CallExpr *, 2> IDCalls;
+    llvm::SmallVector<const CallExpr *, 2> SizeQueries;
+    llvm::SmallVector<const CallExpr *, 2> Barriers;
+    bool UsesLocalMemory = false;
+  };
+
+  const FunctionFacts &getFacts(const FunctionDecl *Func);
+
+  std::unique_ptr<CallGraph> Graph;
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<FunctionFacts>>
+      FactsCache;
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<KernelInfo>>
+      KernelCache;
+};
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_KERNEL_CLASSIFIER_H
@@ -119,6 +119,111 @@ llvm::Optional<Token> getConstQualifyingToken(CharSourceRange Range,
   // type.  Otherwise, the first `const` token, if any, is the qualifier.
   return LastTokInRange.is(tok::kw_const) ? LastTokInRange : FirstConstTok;
 }
+
+/// Lexes the attributes after the declarator of \p D up to the identifier
+/// \p Attribute. Returns false if the declarator ends before it.
+static bool lexToAttribute(const NamedDecl *D, StringRef Attribute,
+                           const SourceManager &SM, const LangOptions &LangOpts,
+                           llvm::Optional<Lexer> &RawLexer) {
+  const SourceLocation Loc = D->getLocation();
+  if (Loc.isInvalid() || Loc.isMacroID())
+    return false;
+  std::pair<FileID, unsigned> LocInfo = SM.getDecomposedLoc(Loc);
+  bool Invalid = false;
+  StringRef File = SM.getBufferData(LocInfo.first, &Invalid);
+  if (Invalid)
+    return false;
+  RawLexer.emplace(SM.getLocForStartOfFile(LocInfo.first), LangOpts,
+                   File.begin(), File.data() + LocInfo.second, File.end());
+  Token Tok;
+  // Skip the name of the declaration.
+  RawLexer->LexFromRawLexer(Tok);
+  // The attributes end with the declarator, at the first ',', ';', '{' or '='
+  // outside of parentheses, or at the ')' closing a parameter list.
+  unsigned Depth = 0;
+  while (!RawLexer->LexFromRawLexer(Tok)) {
+    if (Tok.is(tok::l_paren)) {
+      ++Depth;
+    } else if (Tok.is(tok::r_paren)) {
+      if (Depth-- == 0)
+        return false;
+    } else if (Depth == 0 &&
+               Tok.isOneOf(tok::comma, tok::semi, tok::l_brace, tok::equal)) {
+      return false;
+    } else if (Tok.is(tok::raw_identifier) &&
+               Tok.getRawIdentifier() == Attribute) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool hasAttribute(const NamedDecl *D, StringRef Attribute,
+                  const SourceManager &SM, const LangOptions &LangOpts) {
+  llvm::Optional<Lexer> RawLexer;
+  return lexToAttribute(D, Attribute, SM, LangOpts, RawLexer);
+}
+
+bool hasLeadingAttribute(const NamedDecl *D, StringRef Attribute,
+                         const SourceManager &SM, const LangOptions &LangOpts) {
+  const SourceLocation Begin = D->getBeginLoc();
+  const SourceLocation End = D->getLocation();
+  if (Begin.isInvalid() || Begin.isMacroID() || End.isInvalid() ||
+      End.isMacroID())
+    return false;
+  std::pair<FileID, unsigned> LocInfo = SM.getDecomposedLoc(Begin);
+  if (LocInfo.first != SM.getFileID(End))
+    return false;
+  bool Invalid = false;
+  StringRef File = SM.getBufferData(LocInfo.first, &Invalid);
+  if (Invalid)
+    return false;
+  Lexer RawLexer(SM.getLocForStartOfFile(LocInfo.first), LangOpts,
+                 File.begin(), File.data() + LocInfo.second, File.end());
+  // Only the names in the list of an __attribute__((...)), not their
+  // arguments, comments or other identifiers, are attributes.
+  const std::string Reserved = ("__" + Attribute + "__").str();
+  bool InAttribute = false;
+  unsigned Depth = 0;
+  Token Tok;
+  while (!RawLexer.LexFromRawLexer(Tok) &&
+         SM.isBeforeInTranslationUnit(Tok.getLocation(), End)) {
+    if (!InAttribute) {
+      InAttribute = Tok.is(tok::raw_identifier) &&
+                    (Tok.getRawIdentifier() == "__attribute__" ||
+                     Tok.getRawIdentifier() == "__attribute");
+      Depth = 0;
+    } else if (Tok.is(tok::l_paren)) {
+      ++Depth;
+    } else if (Tok.is(tok::r_paren)) {
+      if (Depth == 0 || --Depth == 0)
+        InAttribute = false;
+    } else if (Depth == 0) {
+      InAttribute = false;
+    } else if (Depth == 2 && Tok.is(tok::raw_identifier) &&
+               (Tok.getRawIdentifier() == Attribute ||
+                Tok.getRawIdentifier() == Reserved)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+llvm::Optional<uint64_t> getAttributeArgument(const NamedDecl *D,
+                                              StringRef Attribute,
+                                              const SourceManager &SM,
+                                              const LangOptions &LangOpts) {
+  llvm::Optional<Lexer> RawLexer;
+  if (!lexToAttribute(D, Attribute, SM, LangOpts, RawLexer))
+    return llvm::None;
+  Token Tok;
+  uint64_t Value = 0;
+  if (RawLexer->LexFromRawLexer(Tok) || Tok.isNot(tok::l_paren) ||
+      RawLexer->LexFromRawLexer(Tok) || Tok.isNot(tok::numeric_constant) ||
+      StringRef(Tok.getLiteralData(), Tok.getLength()).getAsInteger(0, Value))
+    return llvm::None;
+  return Value;
+}
 } // namespace lexer
 } // namespace utils
 } // namespace tidy
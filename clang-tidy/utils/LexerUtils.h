@@ -89,6 +89,28 @@ llvm::Optional<Token> getConstQualifyingToken(CharSourceRange Range,
                                               const ASTContext &Context,
                                               const SourceManager &SM);
 
+/// Returns true if the attribute \p Attribute is written after the declarator
+/// of \p D. This is meant for vendor attributes that clang ignores, such as
+/// ``__attribute__((blocking))``.
+bool hasAttribute(const NamedDecl *D, StringRef Attribute,
+                  const SourceManager &SM, const LangOptions &LangOpts);
+
+/// Returns true if the attribute \p Attribute is written in an
+/// ``__attribute__((...))`` before the name of \p D, such as
+/// ``__attribute__((num_simd_work_items(4)))`` in front of a kernel. This is
+/// meant for vendor attributes that clang ignores.
+bool hasLeadingAttribute(const NamedDecl *D, StringRef Attribute,
+                         const SourceManager &SM, const LangOptions &LangOpts);
+
+/// Returns the integer argument of the attribute \p Attribute written after
+/// the declarator of \p D, such as ``__attribute__((depth(8)))``. This is
+/// meant for vendor attributes that clang ignores. Returns ``None`` if the
+/// attribute is not found or its argument is not an integer literal.
+llvm::Optional<uint64_t> getAttributeArgument(const NamedDecl *D,
+                                              StringRef Attribute,
+                                              const SourceManager &SM,
+                                              const LangOptions &LangOpts);
+
 } // namespace lexer
 } // namespace utils
 } // namespace tidy
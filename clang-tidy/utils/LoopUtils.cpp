@@ -0,0 +1,73 @@
+//===--- LoopUtils.cpp - clang-tidy ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LoopUtils.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+bool isLoop(const Stmt *S) {
+  return isa<ForStmt>(S) || isa<WhileStmt>(S) || isa<DoStmt>(S);
+}
+
+const LoopHintAttr *getLoopHint(const Stmt *Loop,
+                                LoopHintAttr::OptionType Option,
+                                ASTContext &Context) {
+  for (const auto &Parent : Context.getParents(*Loop))
+    if (const auto *Attributed = Parent.get<AttributedStmt>())
+      for (const Attr *A : Attributed->getAttrs())
+        if (const auto *Hint = dyn_cast<LoopHintAttr>(A))
+          if (Hint->getOption() == Option)
+            return Hint;
+  return nullptr;
+}
+
+bool isFullyUnrolled(const Stmt *Loop, ASTContext &Context) {
+  const LoopHintAttr *Hint = getLoopHint(Loop, LoopHintAttr::Unroll, Context);
+  return Hint && Hint->getState() != LoopHintAttr::Disable;
+}
+
+unsigned countReferences(const Stmt *S, const ValueDecl *D) {
+  if (!S)
+    return 0;
+  unsigned Count = 0;
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(S))
+    Count = Ref->getDecl() == D;
+  else if (const auto *Member = dyn_cast<MemberExpr>(S))
+    Count = Member->getMemberDecl() == D;
+  for (const Stmt *Child : S->children())
+    Count += countReferences(Child, D);
+  return Count;
+}
+
+SourceLocation getStartOfLoopLines(const Stmt *Loop, const SourceManager &SM) {
+  if (Loop->getBeginLoc().isMacroID())
+    return SourceLocation();
+  const std::pair<FileID, unsigned> Decomposed =
+      SM.getDecomposedLoc(Loop->getBeginLoc());
+  bool Invalid = false;
+  const StringRef Buffer = SM.getBufferData(Decomposed.first, &Invalid);
+  if (Invalid)
+    return SourceLocation();
+  size_t Start = Buffer.substr(0, Decomposed.second).find_last_of('\n') + 1;
+  if (!Buffer.slice(Start, Decomposed.second).trim().empty())
+    return SourceLocation();
+  while (Start > 0) {
+    const StringRef Preceding = Buffer.substr(0, Start - 1);
+    const size_t LineStart = Preceding.find_last_of('\n') + 1;
+    if (!Preceding.substr(LineStart).ltrim().startswith("#pragma"))
+      break;
+    Start = LineStart;
+  }
+  return SM.getComposedLoc(Decomposed.first, Start);
+}
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
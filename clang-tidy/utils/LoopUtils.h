@@ -0,0 +1,47 @@
+//===--- LoopUtils.h - clang-tidy -------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_LOOP_UTILS_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_LOOP_UTILS_H
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Attr.h"
+#include "clang/AST/Stmt.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+/// Returns true if \p S is a for, while or do..while loop.
+bool isLoop(const Stmt *S);
+
+/// Returns the loop hint with the given \p Option that a ``#pragma unroll``,
+/// ``#pragma nounroll`` or ``#pragma clang loop`` directive attaches to
+/// \p Loop, or nullptr.
+const LoopHintAttr *getLoopHint(const Stmt *Loop,
+                                LoopHintAttr::OptionType Option,
+                                ASTContext &Context);
+
+/// Returns true if \p Loop is unrolled completely, by ``#pragma unroll``
+/// without a factor or by ``#pragma clang loop unroll(enable|full)``.
+bool isFullyUnrolled(const Stmt *Loop, ASTContext &Context);
+
+/// Returns the number of references to \p D within \p S, by name or, for a
+/// field, as a member.
+unsigned countReferences(const Stmt *S, const ValueDecl *D);
+
+/// Returns the start of the line of \p Loop or, if it is preceded by #pragma
+/// directives, of the first of them. Returns an invalid location if anything
+/// but whitespace precedes the loop on its line.
+SourceLocation getStartOfLoopLines(const Stmt *Loop, const SourceManager &SM);
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_LOOP_UTILS_H
@@ -0,0 +1,321 @@
+//===--- MemoryAccessPattern.cpp - clang-tidy -----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "MemoryAccessPattern.h"
+#include "InductionVariable.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/CheckedArithmetic.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+namespace {
+
+const unsigned MaxSubstitutionDepth = 8;
+
+const VarDecl *getReferencedVar(const Expr *E) {
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts()))
+    return dyn_cast<VarDecl>(Ref->getDecl());
+  return nullptr;
+}
+
+/// Returns the array variable of \p Base, looking through the subscripts of
+/// multi-dimensional arrays.
+const VarDecl *getArrayBase(const Expr *Base, bool &IsMultiDimensional) {
+  Base = Base->IgnoreParenImpCasts();
+  while (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(Base)) {
+    IsMultiDimensional = true;
+    Base = Subscript->getBase()->IgnoreParenImpCasts();
+  }
+  return getReferencedVar(Base);
+}
+
+void collectAccesses(const Stmt *S, bool IsWrite, bool IsRead,
+                     llvm::SmallVectorImpl<MemoryAccess> &Accesses) {
+  if (!S)
+    return;
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(S)) {
+    if (BinOp->isAssignmentOp()) {
+      // A compound assignment reads the element before writing it.
+      collectAccesses(BinOp->getLHS(), true, BinOp->isCompoundAssignmentOp(),
+                      Accesses);
+      collectAccesses(BinOp->getRHS(), false, true, Accesses);
+      return;
+    }
+  } else if (const auto *Unary = dyn_cast<UnaryOperator>(S)) {
+    if (Unary->isIncrementDecrementOp()) {
+      collectAccesses(Unary->getSubExpr(), true, true, Accesses);
+      return;
+    }
+    if (Unary->getOpcode() == UO_Deref) {
+      const Expr *Pointer = Unary->getSubExpr()->IgnoreParenImpCasts();
+      MemoryAccess Access;
+      Access.Access = Unary;
+      Access.IsWrite = IsWrite;
+      Access.IsRead = IsRead;
+      if ((Access.Base = getReferencedVar(Pointer))) {
+        Accesses.push_back(Access);
+      } else if (const auto *Arith = dyn_cast<BinaryOperator>(Pointer)) {
+        // *(A + i), *(i + A) and *(A - i).
+        if (Arith->isAdditiveOp()) {
+          const bool LHSIsPointer = Arith->getLHS()->getType()->isPointerType();
+          Access.Base =
+              getReferencedVar(LHSIsPointer ? Arith->getLHS() : Arith->getRHS());
+          Access.Index = LHSIsPointer ? Arith->getRHS() : Arith->getLHS();
+          if (Access.Base)
+            Accesses.push_back(Access);
+        }
+      }
+    }
+  } else if (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(S)) {
+    // A[i] in A[i][j] only computes the address of a row.
+    if (!Subscript->getType()->isArrayType()) {
+      MemoryAccess Access;
+      Access.Access = Subscript;
+      Access.Index = Subscript->getIdx();
+      Access.IsWrite = IsWrite;
+      Access.IsRead = IsRead;
+      Access.Base =
+          getArrayBase(Subscript->getBase(), Access.IsMultiDimensional);
+      if (Access.Base)
+        Accesses.push_back(Access);
+    }
+  } else if (isa<ParenExpr>(S)) {
+    collectAccesses(cast<ParenExpr>(S)->getSubExpr(), IsWrite, IsRead,
+                    Accesses);
+    return;
+  } else if (const auto *Member = dyn_cast<MemberExpr>(S)) {
+    // A store to A[i].x writes to A[i].
+    if (!Member->isArrow()) {
+      collectAccesses(Member->getBase(), IsWrite, IsRead, Accesses);
+      return;
+    }
+  }
+  for (const Stmt *Child : S->children())
+    collectAccesses(Child, false, true, Accesses);
+}
+
+/// Returns true if \p Name is a work-item function that returns the same value
+/// for all the work-items of a work-group.
+bool isUniformIDQuery(StringRef Name) {
+  return llvm::StringSwitch<bool>(Name)
+      .Cases("get_group_id", "get_num_groups", "get_global_size",
+             "get_local_size", "get_enqueued_local_size", true)
+      .Cases("get_global_offset", "get_work_dim", true)
+      .Default(false);
+}
+
+AccessStride irregular() {
+  AccessStride Result;
+  Result.Kind = AccessStride::Irregular;
+  return Result;
+}
+
+AccessStride constant(int64_t Value) {
+  AccessStride Result;
+  Result.Value = Value;
+  return Result;
+}
+
+AccessStride add(const AccessStride &LHS, const AccessStride &RHS,
+                 bool Subtract) {
+  if (LHS.Kind == AccessStride::Irregular ||
+      RHS.Kind == AccessStride::Irregular)
+    return irregular();
+  if (LHS.Kind == AccessStride::Symbolic || RHS.Kind == AccessStride::Symbolic) {
+    AccessStride Result;
+    Result.Kind = AccessStride::Symbolic;
+    return Result;
+  }
+  llvm::Optional<int64_t> Value =
+      Subtract ? llvm::checkedSub(LHS.Value, RHS.Value)
+               : llvm::checkedAdd(LHS.Value, RHS.Value);
+  return Value ? constant(*Value) : irregular();
+}
+
+/// Returns the stride of Factor * E, given the stride of E.
+AccessStride scale(const AccessStride &Stride, const Expr *Factor,
+                   const ASTContext &Context) {
+  if (Stride.isUniform() || Stride.Kind == AccessStride::Irregular)
+    return Stride;
+  llvm::Optional<int64_t> Value = evaluateInteger(Factor, Context);
+  if (!Value) {
+    AccessStride Result;
+    Result.Kind = AccessStride::Symbolic;
+    return Result;
+  }
+  if (Stride.Kind == AccessStride::Symbolic)
+    return *Value == 0 ? constant(0) : Stride;
+  llvm::Optional<int64_t> Product = llvm::checkedMul(Stride.Value, *Value);
+  return Product ? constant(*Product) : irregular();
+}
+
+} // namespace
+
+void collectMemoryAccesses(const Stmt *S,
+                           llvm::SmallVectorImpl<MemoryAccess> &Accesses) {
+  collectAccesses(S, false, true, Accesses);
+}
+
+void collectModifiedVars(const Stmt *S,
+                         llvm::SmallPtrSetImpl<const VarDecl *> &Vars) {
+  if (!S)
+    return;
+  if (const auto *BinOp = dyn_cast<BinaryOperator>(S)) {
+    if (BinOp->isAssignmentOp())
+      if (const VarDecl *Var = getReferencedVar(BinOp->getLHS()))
+        Vars.insert(Var);
+  } else if (const auto *Unary = dyn_cast<UnaryOperator>(S)) {
+    if (Unary->isIncrementDecrementOp() || Unary->getOpcode() == UO_AddrOf)
+      if (const VarDecl *Var = getReferencedVar(Unary->getSubExpr()))
+        Vars.insert(Var);
+  }
+  for (const Stmt *Child : S->children())
+    collectModifiedVars(Child, Vars);
+}
+
+QualType getElementType(QualType Type, const ASTContext &Context) {
+  if (const auto *Pointer = Type->getAs<PointerType>())
+    return Pointer->getPointeeType();
+  if (const ArrayType *Array = Context.getAsArrayType(Type))
+    return Array->getElementType();
+  return QualType();
+}
+
+StrideAnalyzer::StrideAnalyzer(
+    const FunctionDecl *Func, const IdDependencyAnalyzer::FunctionInfo &IDInfo,
+    const ASTContext &Context)
+    : IDInfo(IDInfo), Context(Context) {
+  collectModifiedVars(Func->getBody(), Modified);
+}
+
+AccessStride StrideAnalyzer::getStride(const Expr *Index) const {
+  if (!Index)
+    return constant(0);
+  return getStrideImpl(Index, nullptr, 0);
+}
+
+AccessStride StrideAnalyzer::getStride(const Expr *Index,
+                                       const StrideLoop &Loop) const {
+  if (!Index)
+    return constant(0);
+  return getStrideImpl(Index, &Loop, 0);
+}
+
+AccessStride StrideAnalyzer::getVarStride(const VarDecl *Var,
+                                          const StrideLoop *Loop,
+                                          unsigned Depth) const {
+  if (Loop && Var == Loop->InductionVar)
+    return constant(Loop->Step);
+  if (Loop && Loop->Varying.count(Var))
+    return irregular();
+  // A variable that keeps the value of its initializer is equivalent to it.
+  if (Var->isLocalVarDecl() && Var->getInit() && !Modified.count(Var) &&
+      Var->getType()->isIntegerType() && Depth < MaxSubstitutionDepth)
+    return getStrideImpl(Var->getInit(), Loop, Depth + 1);
+  if (!Loop && IDInfo.isIDDependent(Var))
+    return irregular();
+  return constant(0);
+}
+
+AccessStride StrideAnalyzer::getStrideImpl(const Expr *E,
+                                           const StrideLoop *Loop,
+                                           unsigned Depth) const {
+  E = E->IgnoreParenCasts();
+  if (evaluateInteger(E, Context))
+    return constant(0);
+
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(E)) {
+    if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+      return getVarStride(Var, Loop, Depth);
+    return constant(0);
+  }
+
+  if (const auto *Call = dyn_cast<CallExpr>(E)) {
+    const FunctionDecl *Callee = Call->getDirectCallee();
+    if (IdDependencyAnalyzer::isIDFunction(Callee)) {
+      if (Loop)
+        return constant(0);
+      llvm::Optional<int64_t> Dimension =
+          Call->getNumArgs() == 1
+              ? evaluateInteger(Call->getArg(0), Context)
+              : llvm::None;
+      if (!Dimension)
+        return irregular();
+      // Dimension 0 varies fastest between the work-items of a work-group.
+      return constant(*Dimension == 0 ? 1 : 0);
+    }
+    if (Callee && Callee->getIdentifier()) {
+      if (isUniformIDQuery(Callee->getName()))
+        return constant(0);
+      // The linear IDs are computed with dimension 0 varying fastest.
+      if (Callee->getName() == "get_global_linear_id" ||
+          Callee->getName() == "get_local_linear_id")
+        return constant(Loop ? 0 : 1);
+    }
+    if (!Loop && IDInfo.findIDCall(Call))
+      return irregular();
+  } else if (const auto *Unary = dyn_cast<UnaryOperator>(E)) {
+    AccessStride Sub = getStrideImpl(Unary->getSubExpr(), Loop, Depth);
+    if (Unary->getOpcode() == UO_Plus)
+      return Sub;
+    if (Unary->getOpcode() == UO_Minus)
+      return add(constant(0), Sub, /*Subtract=*/true);
+    return Sub.isUniform() ? Sub : irregular();
+  } else if (const auto *BinOp = dyn_cast<BinaryOperator>(E)) {
+    AccessStride LHS = getStrideImpl(BinOp->getLHS(), Loop, Depth);
+    AccessStride RHS = getStrideImpl(BinOp->getRHS(), Loop, Depth);
+    switch (BinOp->getOpcode()) {
+    case BO_Add:
+      return add(LHS, RHS, /*Subtract=*/false);
+    case BO_Sub:
+      return add(LHS, RHS, /*Subtract=*/true);
+    case BO_Mul:
+      if (LHS.isUniform())
+        return scale(RHS, BinOp->getLHS(), Context);
+      if (RHS.isUniform())
+        return scale(LHS, BinOp->getRHS(), Context);
+      return irregular();
+    case BO_Shl:
+      if (RHS.isUniform()) {
+        llvm::Optional<int64_t> Shift =
+            evaluateInteger(BinOp->getRHS(), Context);
+        if (Shift && *Shift >= 0 && *Shift < 32 &&
+            LHS.Kind == AccessStride::Constant) {
+          llvm::Optional<int64_t> Product =
+              llvm::checkedMul<int64_t>(LHS.Value, int64_t(1) << *Shift);
+          return Product ? constant(*Product) : irregular();
+        }
+        if (!Shift)
+          return scale(LHS, BinOp->getRHS(), Context);
+        if (LHS.Kind == AccessStride::Symbolic)
+          return LHS;
+      }
+      break;
+    case BO_Comma:
+      return RHS;
+    default:
+      break;
+    }
+    return LHS.isUniform() && RHS.isUniform() ? constant(0) : irregular();
+  }
+
+  // Anything else, including loads from memory, has a stride of 0 if all of
+  // its operands are uniform, and no regular pattern otherwise.
+  for (const Stmt *Child : E->children()) {
+    const auto *ChildExpr = dyn_cast_or_null<Expr>(Child);
+    if (ChildExpr && !getStrideImpl(ChildExpr, Loop, Depth).isUniform())
+      return irregular();
+  }
+  return constant(0);
+}
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,127 @@
+//===--- MemoryAccessPattern.h - clang-tidy ---------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_MEMORY_ACCESS_PATTERN_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_MEMORY_ACCESS_PATTERN_H
+
+#include "IdDependencyAnalyzer.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+/// An access to an element of an array or of the memory a pointer points to,
+/// such as ``A[i]``, ``*(A + i)`` or ``*A``.
+struct MemoryAccess {
+  /// The subscript or dereference expression.
+  const Expr *Access = nullptr;
+  /// The array or pointer variable that is accessed.
+  const VarDecl *Base = nullptr;
+  /// The index of the accessed element, or nullptr for ``*A``. For
+  /// multi-dimensional arrays, the index in the last dimension.
+  const Expr *Index = nullptr;
+  /// True if the element is written, including by compound assignments and
+  /// increments.
+  bool IsWrite = false;
+  /// True if the element is read, which excludes plain assignments.
+  bool IsRead = true;
+  /// True if `Access` is the last subscript of a multi-dimensional array,
+  /// such as ``A[i][j]``.
+  bool IsMultiDimensional = false;
+};
+
+/// Collects the accesses through a named array or pointer within \p S, in
+/// source order.
+void collectMemoryAccesses(const Stmt *S,
+                           llvm::SmallVectorImpl<MemoryAccess> &Accesses);
+
+/// Collects the variables that are assigned, incremented, decremented or have
+/// their address taken within \p S.
+void collectModifiedVars(const Stmt *S,
+                         llvm::SmallPtrSetImpl<const VarDecl *> &Vars);
+
+/// Returns the element type of an array, or the pointee type of a pointer.
+QualType getElementType(QualType Type, const ASTContext &Context);
+
+/// How much the value of an index expression changes between two consecutive
+/// work-items, or two consecutive iterations of a loop.
+struct AccessStride {
+  enum StrideKind {
+    /// The index changes by `Value`, which is 0 for uniform accesses.
+    Constant,
+    /// The index changes by an amount that is the same every time, but is
+    /// only known at run-time, such as the row size of a matrix.
+    Symbolic,
+    /// The index is not an affine function of the work-item ID or induction
+    /// variable, e.g. because it is loaded from memory.
+    Irregular
+  };
+  StrideKind Kind = Constant;
+  int64_t Value = 0;
+
+  bool isUniform() const { return Kind == Constant && Value == 0; }
+  bool isContiguous() const {
+    return Kind == Constant && (Value == 1 || Value == -1);
+  }
+};
+
+/// A loop whose consecutive iterations the stride is computed between.
+struct StrideLoop {
+  /// The induction variable, which changes by `Step` every iteration.
+  const VarDecl *InductionVar = nullptr;
+  int64_t Step = 1;
+  /// The other variables modified in the loop. Variables of loops nested in it
+  /// that are fully unrolled do not belong here, since every unrolled copy
+  /// sees a constant value.
+  llvm::SmallPtrSet<const VarDecl *, 8> Varying;
+};
+
+/// Computes the stride of index expressions with respect to either the
+/// work-item ID in dimension 0, which varies fastest between the work-items
+/// of an NDRange kernel, or the induction variable of a loop.
+///
+/// Local variables that are only ever given a value by their initializer are
+/// looked through, so ``int gid = get_global_id(0); A[gid]`` is recognized as
+/// contiguous.
+class StrideAnalyzer {
+public:
+  StrideAnalyzer(const FunctionDecl *Func,
+                 const IdDependencyAnalyzer::FunctionInfo &IDInfo,
+                 const ASTContext &Context);
+
+  /// Returns the stride of \p Index, in elements, between consecutive
+  /// work-items.
+  AccessStride getStride(const Expr *Index) const;
+
+  /// Returns the stride of \p Index, in elements, between consecutive
+  /// iterations of \p Loop.
+  AccessStride getStride(const Expr *Index, const StrideLoop &Loop) const;
+
+private:
+  AccessStride getStrideImpl(const Expr *E, const StrideLoop *Loop,
+                             unsigned Depth) const;
+  /// Returns the stride of a reference to \p Var.
+  AccessStride getVarStride(const VarDecl *Var, const StrideLoop *Loop,
+                            unsigned Depth) const;
+
+  const IdDependencyAnalyzer::FunctionInfo &IDInfo;
+  const ASTContext &Context;
+  /// Variables modified anywhere in the function, which cannot be replaced by
+  /// their initializer.
+  llvm::SmallPtrSet<const VarDecl *, 16> Modified;
+};
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_MEMORY_ACCESS_PATTERN_H
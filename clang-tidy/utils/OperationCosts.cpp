@@ -0,0 +1,56 @@
+//===--- OperationCosts.cpp - clang-tidy ----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OperationCosts.h"
+#include "llvm/ADT/StringSet.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+namespace {
+
+/// Rough costs from the area and latency reports of the Intel FPGA SDK for
+/// OpenCL. The DSP blocks implement single-precision additions and
+/// multiplications; integer division and double-precision additions are built
+/// from logic, and 64-bit operations are split across several DSP blocks.
+const OperationCost OperationCosts[NumOperationKinds] = {
+    {"int-add", 0, 16, 1},          {"int-mul", 1, 40, 3},
+    {"int-div", 0, 1100, 36},       {"long-mul", 4, 100, 6},
+    {"long-div", 0, 3500, 68},      {"float-add", 1, 0, 4},
+    {"float-mul", 1, 0, 4},         {"float-div", 4, 250, 16},
+    {"double-add", 0, 800, 12},     {"double-mul", 4, 250, 12},
+    {"double-div", 0, 3500, 40},    {"math-function", 4, 1500, 40},
+    {"double-math", 16, 5000, 120}, {"pow", 8, 3000, 90},
+    {"exp", 4, 1500, 40}};
+
+const llvm::StringSet<> MathFunctions = {
+    "acos",  "acosh", "asin",  "asinh", "atan",  "atan2", "atanh", "cbrt",
+    "cos",   "cosh",  "erf",   "erfc",  "exp",   "exp2",  "exp10", "expm1",
+    "fmod",  "hypot", "log",   "log10", "log1p", "log2",  "pow",   "pown",
+    "powr",  "rootn", "rsqrt", "sin",   "sincos", "sinh", "sqrt",  "tan",
+    "tanh",  "tgamma"};
+
+} // namespace
+
+const OperationCost &getOperationCost(OperationKind Kind) {
+  return OperationCosts[Kind];
+}
+
+llvm::Optional<OperationKind> getOperationKind(llvm::StringRef Name) {
+  for (unsigned Kind = 0; Kind != NumOperationKinds; ++Kind)
+    if (Name == OperationCosts[Kind].Name)
+      return static_cast<OperationKind>(Kind);
+  return llvm::None;
+}
+
+bool isMathFunction(llvm::StringRef Name) { return MathFunctions.count(Name); }
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
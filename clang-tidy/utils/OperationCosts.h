@@ -0,0 +1,67 @@
+//===--- OperationCosts.h - clang-tidy --------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_OPERATION_COSTS_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_OPERATION_COSTS_H
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace clang {
+namespace tidy {
+namespace utils {
+
+/// The kinds of arithmetic operations whose cost on an FPGA is estimated.
+/// Integer kinds are 32-bit operations unless they are named ``Long``, and
+/// math functions are single-precision unless they are named ``Double``.
+enum OperationKind {
+  IntAdd,
+  IntMul,
+  IntDiv,
+  LongMul,
+  LongDiv,
+  FloatAdd,
+  FloatMul,
+  FloatDiv,
+  DoubleAdd,
+  DoubleMul,
+  DoubleDiv,
+  MathFunction,
+  DoubleMathFunction,
+  Pow,
+  Exp,
+  NumOperationKinds
+};
+
+/// The resources and latency of a single scalar operation.
+struct OperationCost {
+  /// The name of the kind in options and reports, such as ``int-div``.
+  const char *Name;
+  unsigned DSPs;
+  unsigned ALMs;
+  /// The cycles that the operation adds to the latency of a pipeline.
+  unsigned Latency;
+};
+
+/// Returns the default cost of an operation of kind \p Kind on an Intel
+/// Arria 10 or Stratix 10.
+const OperationCost &getOperationCost(OperationKind Kind);
+
+/// Returns the kind of operation whose cost is named \p Name.
+llvm::Optional<OperationKind> getOperationKind(llvm::StringRef Name);
+
+/// Returns true if \p Name is an OpenCL math built-in that is implemented as a
+/// dedicated core, such as ``sqrt`` or ``exp``, rather than with a few
+/// arithmetic operators.
+bool isMathFunction(llvm::StringRef Name);
+
+} // namespace utils
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_OPERATION_COSTS_H
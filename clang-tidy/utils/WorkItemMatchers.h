@@ -0,0 +1,52 @@
+//===--- WorkItemMatchers.h - clang-tidy ------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_WORK_ITEM_MATCHERS_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_WORK_ITEM_MATCHERS_H
+
+#include "ASTUtils.h"
+#include "DivergenceAnalyzer.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+
+namespace clang {
+namespace tidy {
+namespace matchers {
+
+/// Matches expressions that have the same value in every work-item of a
+/// work-group, i.e. that neither call an ID function, reference an
+/// ID-dependent variable or field, nor call a function returning an
+/// ID-dependent value. Expressions outside of a function are uniform.
+///
+/// The ID-dependencies of each function are computed once per translation
+/// unit by \p Analyzer, which the check owns.
+AST_MATCHER_P(Expr, isWorkItemUniform, utils::DivergenceAnalyzer *,
+              Analyzer) {
+  ASTContext &Context = Finder->getASTContext();
+  const FunctionDecl *Func = utils::getSurroundingFunction(Context, Node);
+  if (!Func)
+    return true;
+  return !Analyzer->analyzeIDDependency(Func, Context).isIDDependent(&Node);
+}
+
+/// Matches statements that some work-items of a work-group may execute and
+/// others not, because a branch whose condition is not work-item uniform
+/// decides whether they are executed.
+AST_MATCHER_P(Stmt, isInDivergentRegion, utils::DivergenceAnalyzer *,
+              Analyzer) {
+  ASTContext &Context = Finder->getASTContext();
+  const FunctionDecl *Func = utils::getSurroundingFunction(Context, Node);
+  if (!Func)
+    return false;
+  return Analyzer->analyze(Func, Context).isInDivergentRegion(&Node);
+}
+
+} // namespace matchers
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_UTILS_WORK_ITEM_MATCHERS_H
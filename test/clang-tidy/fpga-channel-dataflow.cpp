@@ -0,0 +1,108 @@
+// RUN: %check_clang_tidy %s fpga-channel-dataflow %t -- -header-filter=.* "--" -cl-std=CL2.0 -c --include opencl-c.h
+
+// Stand-ins for the channel type and built-ins of the Intel FPGA SDK.
+typedef int channel_int;
+int read_channel_intel(channel_int Channel);
+int read_channel_nb_intel(channel_int Channel, bool *Valid);
+void write_channel_intel(channel_int Channel, int Value);
+
+channel_int Balanced;
+
+__kernel void producer(__global const int *In) {
+  for (int i = 0; i < 16; ++i)
+    write_channel_intel(Balanced, In[i]);
+}
+
+__kernel void consumer(__global int *Out) {
+  for (int i = 0; i < 16; ++i)
+    Out[i] = read_channel_intel(Balanced);
+}
+
+channel_int Unbalanced;
+// CHECK-MESSAGES: :[[@LINE-1]]:13: warning: channel 'Unbalanced' is written 16 times but read 8 times per kernel invocation, which blocks the producer forever [fpga-channel-dataflow]
+
+__kernel void unbalanced_producer(__global const int *In) {
+  for (int i = 0; i < 16; ++i)
+    write_channel_intel(Unbalanced, In[i]);
+}
+
+__kernel void unbalanced_consumer(__global int *Out) {
+  for (int i = 0; i < 8; ++i)
+    Out[i] = read_channel_intel(Unbalanced);
+}
+
+channel_int Wide;
+// CHECK-MESSAGES: :[[@LINE-1]]:13: warning: channel 'Wide' has a depth of 0, but the producer writes 4 items and the consumer reads 1 item per loop iteration; declare it with a depth of at least 4 to avoid stalling the pipeline [fpga-channel-dataflow]
+// CHECK-FIXES: channel_int Wide __attribute__((depth(4)));
+channel_int Deep __attribute__((depth(8)));
+
+__kernel void wide_producer(__global const int *In) {
+  for (int i = 0; i < 64; i += 4) {
+#pragma unroll
+    for (int j = 0; j < 4; ++j) {
+      write_channel_intel(Wide, In[i + j]);
+      write_channel_intel(Deep, In[i + j]);
+    }
+  }
+}
+
+__kernel void narrow_consumer(__global int *Out) {
+  for (int i = 0; i < 64; ++i)
+    Out[i] = read_channel_intel(Wide) + read_channel_intel(Deep);
+}
+
+channel_int Request;
+// CHECK-MESSAGES: :[[@LINE-1]]:13: warning: kernels 'client' -> 'server' -> 'client' form a cycle of blocking accesses through 'Request', 'Response'; it deadlocks if a channel in the cycle fills up, unless the channel depths cover all the items in flight [fpga-channel-dataflow]
+channel_int Response;
+
+__kernel void client(__global int *Out) {
+  write_channel_intel(Request, 1);
+  Out[0] = read_channel_intel(Response);
+}
+
+__kernel void server() {
+  write_channel_intel(Response, read_channel_intel(Request) * 2);
+}
+
+// Non-blocking reads cannot deadlock
+channel_int Ping;
+channel_int Pong;
+
+__kernel void pinger(__global int *Out) {
+  bool Valid;
+  write_channel_intel(Ping, 1);
+  Out[0] = read_channel_nb_intel(Pong, &Valid);
+}
+
+__kernel void ponger() {
+  write_channel_intel(Pong, read_channel_intel(Ping));
+}
+
+__kernel void pipe_producer(write_only pipe int Data __attribute__((blocking))) {
+// CHECK-MESSAGES: :[[@LINE-1]]:49: warning: pipe 'Data' is written 16 times but read 8 times per kernel invocation, which blocks the producer forever [fpga-channel-dataflow]
+  for (int i = 0; i < 16; ++i) {
+    int Value = i;
+    write_pipe(Data, &Value);
+  }
+}
+
+__kernel void pipe_consumer(read_only pipe int Data __attribute__((blocking)),
+                            __global int *Out) {
+  for (int i = 0; i < 8; ++i) {
+    int Value;
+    read_pipe(Data, &Value);
+    Out[i] = Value;
+  }
+}
+
+// The rate of an NDRange kernel depends on the number of work-items
+channel_int PerWorkItem;
+
+__kernel void ndrange_producer(__global const int *In) {
+  write_channel_intel(PerWorkItem, In[get_global_id(0)]);
+}
+
+__kernel void single_work_item_consumer(__global int *Out) {
+  for (int i = 0; i < 16; ++i)
+    Out[i] = read_channel_intel(PerWorkItem);
+}
@@ -0,0 +1,13 @@
+// RUN: %check_clang_tidy %s fpga-expensive-loop-operation %t -- -config="{CheckOptions: [{key: "fpga-expensive-loop-operation.OperationCosts", value: 'int-div:2:40;double-mul:;bogus:1:1'}]}" -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+
+__kernel void costs(__global const int *In, __global int *Out,
+                    __global double *D, int N, int Width) {
+  for (int i = 0; i < N; ++i) {
+    Out[i] = In[i] / Width;
+    // CHECK-MESSAGES: :[[@LINE-1]]:20: warning: integer division by a value that is not a power of two in a pipelined loop is estimated to use 2 DSP blocks and to add 40 cycles of latency [fpga-expensive-loop-operation]
+    D[i] = D[i] * D[i];
+    // CHECK-MESSAGES: :[[@LINE-1]]:17: warning: double-precision multiplication in a pipelined loop is estimated to use 4 DSP blocks and to add 12 cycles of latency [fpga-expensive-loop-operation]
+  }
+}
@@ -0,0 +1,63 @@
+// RUN: %check_clang_tidy %s fpga-expensive-loop-operation %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+
+__kernel void integer(__global const int *In, __global int *Out, int N,
+                      int Width, __global const long *A, __global long *B) {
+  for (int i = 0; i < N; ++i) {
+    Out[i] = In[i] / Width;
+    // CHECK-MESSAGES: :[[@LINE-1]]:20: warning: integer division by a value that is not a power of two in a pipelined loop is estimated to use 0 DSP blocks and to add 36 cycles of latency [fpga-expensive-loop-operation]
+    Out[i] += In[i] % 3;
+    // CHECK-MESSAGES: :[[@LINE-1]]:21: warning: integer remainder by a value that is not a power of two in a pipelined loop is estimated to use 0 DSP blocks and to add 36 cycles of latency [fpga-expensive-loop-operation]
+    B[i] /= Width;
+    // CHECK-MESSAGES: :[[@LINE-1]]:10: warning: integer division by a value that is not a power of two in a pipelined loop is estimated to use 0 DSP blocks and to add 68 cycles of latency [fpga-expensive-loop-operation]
+    B[i] = A[i] * A[i + 1];
+    // CHECK-MESSAGES: :[[@LINE-1]]:17: warning: 64-bit integer multiplication in a pipelined loop is estimated to use 4 DSP blocks and to add 6 cycles of latency [fpga-expensive-loop-operation]
+
+    // Shifts and masks.
+    Out[i] = In[i] / 8 + In[i] % 16;
+    B[i] = A[i] * 4;
+    // 32-bit multiplications fit in a DSP block.
+    Out[i] = In[i] * Width;
+  }
+}
+
+__kernel void precision(__global const double *In, __global double *Out,
+                        __global const float *F, __global float *G, int N) {
+  for (int i = 0; i < N; ++i) {
+    Out[i] = In[i] * 2.0;
+    // CHECK-MESSAGES: :[[@LINE-1]]:20: warning: double-precision multiplication in a pipelined loop is estimated to use 4 DSP blocks and to add 12 cycles of latency [fpga-expensive-loop-operation]
+    Out[i] = sqrt(In[i]);
+    // CHECK-MESSAGES: :[[@LINE-1]]:14: warning: call to 'sqrt' in a pipelined loop is estimated to use 16 DSP blocks and to add 120 cycles of latency [fpga-expensive-loop-operation]
+    G[i] = pow(F[i], 2.5f);
+    // CHECK-MESSAGES: :[[@LINE-1]]:12: warning: call to 'pow' in a pipelined loop is estimated to use 8 DSP blocks and to add 90 cycles of latency [fpga-expensive-loop-operation]
+    vstore4(exp(vload4(i, F)), i, G);
+    // CHECK-MESSAGES: :[[@LINE-1]]:13: warning: call to 'exp' in a pipelined loop is estimated to use 16 DSP blocks and to add 40 cycles of latency [fpga-expensive-loop-operation]
+
+    // Single-precision and native functions.
+    G[i] = sqrt(F[i]) + F[i] / 3.0f;
+    G[i] = native_exp(F[i]) + half_powr(F[i], 2.0f);
+  }
+}
+
+__kernel void unrolled(__global const double *In, __global double *Out,
+                       int N) {
+  for (int i = 0; i < N; ++i) {
+    #pragma unroll 4
+    for (int j = 0; j < 16; ++j) {
+      Out[i * 16 + j] = In[i * 16 + j] * In[j];
+      // CHECK-MESSAGES: :[[@LINE-1]]:40: warning: double-precision multiplication in a pipelined loop is estimated to use 16 DSP blocks and to add 12 cycles of latency, counting the 4 copies created by unrolling [fpga-expensive-loop-operation]
+    }
+  }
+
+  #pragma unroll
+  for (int i = 0; i < 8; ++i)
+    Out[i] = In[i] + 1.0;
+}
+
+// Not in a loop.
+__kernel void straight(__global const double *In, __global double *Out,
+                       int Width) {
+  int i = get_global_id(0);
+  Out[i / Width] = pow(In[i], 2.0) * In[i];
+}
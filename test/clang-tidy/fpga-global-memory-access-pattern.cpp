@@ -0,0 +1,53 @@
+// RUN: %check_clang_tidy %s fpga-global-memory-access-pattern %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__kernel void contiguous(__global const float *A, __global float *B, int N) {
+  int gid = get_global_id(0);
+  B[gid] = A[gid] + A[gid + 1];
+  B[get_global_id(1) * N + get_global_id(0)] = 0.0f;
+  *(B + gid) = 1.0f;
+
+  // Contiguous between loop iterations
+  for (int i = 0; i < N; ++i) {
+    B[gid * N + i] = A[i];
+  }
+
+  // The same element for every work-item
+  B[0] = A[N];
+}
+
+__kernel void strided(__global float *A, int N) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'strided' accesses global memory at 1 contiguous, 3 strided and 0 random sites; only contiguous accesses are served by burst-coalesced load-store units [fpga-global-memory-access-pattern]
+  int gid = get_global_id(0);
+  A[2 * gid] = 0.0f;
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: store to 'A' has a stride of 2 elements (8 bytes) between consecutive work-items, which prevents burst-coalesced accesses to global memory [fpga-global-memory-access-pattern]
+  A[gid * N] = A[gid];
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: store to 'A' has a stride that is only known at run-time between consecutive work-items, which prevents burst-coalesced accesses to global memory [fpga-global-memory-access-pattern]
+
+  for (int i = 0; i < N; i += 4) {
+    A[i] = 1.0f;
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: store to 'A' has a stride of 4 elements (16 bytes) between consecutive loop iterations, which prevents burst-coalesced accesses to global memory [fpga-global-memory-access-pattern]
+  }
+}
+
+__kernel void random(__global float *A, __global const int *Index, int N) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'random' accesses global memory at 2 contiguous, 0 strided and 3 random sites; only contiguous accesses are served by burst-coalesced load-store units [fpga-global-memory-access-pattern]
+  int gid = get_global_id(0);
+  A[Index[gid]] += 1.0f;
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: store to 'A' has an irregular address pattern between consecutive work-items, which prevents burst-coalesced accesses to global memory [fpga-global-memory-access-pattern]
+  A[gid / 2] = 0.0f;
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: store to 'A' has an irregular address pattern between consecutive work-items, which prevents burst-coalesced accesses to global memory [fpga-global-memory-access-pattern]
+
+  for (int i = 0; i < N; ++i) {
+    A[Index[i]] = 0.0f;
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: store to 'A' has an irregular address pattern between consecutive loop iterations, which prevents burst-coalesced accesses to global memory [fpga-global-memory-access-pattern]
+  }
+}
+
+// Only global memory is checked
+__kernel void other_address_spaces(__constant float *C, __global float *A) {
+  __local float L[64];
+  int lid = get_local_id(0);
+  L[lid * 4] = C[lid * 4];
+  barrier(CLK_LOCAL_MEM_FENCE);
+  A[get_global_id(0)] = L[lid];
+}
@@ -81,3 +81,85 @@ void success() {
     }
   }
 }
+
+void pointer_error() {
+  int accumulator = 0;
+  int Bound;
+  int *BoundPtr = &Bound;
+  // CHECK-NOTES: :[[@LINE-2]]:3: warning: inferred assignment of ID-dependent value from ID-dependent variable BoundPtr [fpga-id-dependent-backward-branch]
+  *BoundPtr = get_local_id(0);
+
+  for (int i = 0; i < Bound; i++) {
+    // CHECK-NOTES: :[[@LINE-1]]:19: warning: backward branch (for loop) is ID-dependent due to variable reference to 'Bound' and may cause performance degradation [fpga-id-dependent-backward-branch]
+    accumulator++;
+  }
+}
+
+void loop_carried_error() {
+  int accumulator = 0;
+  int Bound = 100;
+  // CHECK-NOTES: :[[@LINE-1]]:3: warning: assignment of ID-dependent variable Bound [fpga-id-dependent-backward-branch]
+  for (int i = 0; i < Bound; i++) {
+    // CHECK-NOTES: :[[@LINE-1]]:19: warning: backward branch (for loop) is ID-dependent due to variable reference to 'Bound' and may cause performance degradation [fpga-id-dependent-backward-branch]
+    Bound = get_local_id(0);
+  }
+}
+
+void other_function_success() {
+  int accumulator = 0;
+  int Bound = 100;
+  for (int i = 0; i < Bound; i++) {
+    accumulator++;
+  }
+}
+
+// ==== Interprocedural ID-dependency ====
+int id_helper(int Value) {
+  return Value + 1;
+}
+
+void store_id(int *Out) {
+  *Out = get_local_id(0);
+}
+
+void loop_bound_helper(int Bound) {
+  int accumulator = 0;
+  for (int i = 0; i < Bound; i++) {
+    // CHECK-NOTES: :[[@LINE-1]]:19: warning: backward branch (for loop) is ID-dependent due to variable reference to 'Bound' and may cause performance degradation [fpga-id-dependent-backward-branch]
+    accumulator++;
+  }
+}
+
+void interprocedural_error() {
+  int accumulator = 0;
+  int N = id_helper(get_global_id(0));
+  // CHECK-NOTES: :[[@LINE-1]]:3: warning: assignment of ID-dependent variable N [fpga-id-dependent-backward-branch]
+  for (int i = 0; i < N; i++) {
+    // CHECK-NOTES: :[[@LINE-1]]:19: warning: backward branch (for loop) is ID-dependent due to variable reference to 'N' and may cause performance degradation [fpga-id-dependent-backward-branch]
+    accumulator++;
+  }
+
+  for (int i = 0; i < id_helper(get_local_id(0)); i++) {
+    // CHECK-NOTES: :[[@LINE-1]]:19: warning: backward branch (for loop) is ID-dependent due to ID function call and may cause performance degradation [fpga-id-dependent-backward-branch]
+    accumulator++;
+  }
+
+  int Stored;
+  // CHECK-NOTES: :[[@LINE-1]]:3: warning: assignment of ID-dependent variable Stored [fpga-id-dependent-backward-branch]
+  store_id(&Stored);
+  while (accumulator < Stored) {
+    // CHECK-NOTES: :[[@LINE-1]]:10: warning: backward branch (while loop) is ID-dependent due to variable reference to 'Stored' and may cause performance degradation [fpga-id-dependent-backward-branch]
+    accumulator++;
+  }
+
+  loop_bound_helper(get_local_id(0));
+  // CHECK-NOTES: :[[@LINE-1]]:3: warning: ID-dependent argument passed to parameter Bound [fpga-id-dependent-backward-branch]
+}
+
+void interprocedural_success() {
+  int accumulator = 0;
+  int N = id_helper(100);
+  for (int i = 0; i < N; i++) {
+    accumulator++;
+  }
+}
@@ -0,0 +1,5 @@
+// RUN: %check_clang_tidy %s fpga-kernel-name-restriction %t -- -- -include %S/Inputs/fpga-kernel-name-restriction/Verilog.cl -include %S/Inputs/fpga-kernel-name-restriction/thing.h
+
+// CHECK-MESSAGES: :1:1: warning: The kernel source file '{{.*}}Verilog.cl' included on the command line is named 'kernel.cl', 'Verilog.cl', or 'VHDL.cl', which could cause compilation errors. [fpga-kernel-name-restriction]
+
+// Files included with -include that have other names are fine.
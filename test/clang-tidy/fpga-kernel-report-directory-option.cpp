@@ -0,0 +1,63 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %check_clang_tidy %s fpga-kernel-report %t -- -config="{CheckOptions: [{key: fpga-kernel-report.ReportDirectory, value: %t}]}" -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+// RUN: cat %t/*.kernels.json | FileCheck %s -check-prefix=CHECK-JSON
+
+__kernel void vector_add(__global const float *A, __global const float *B,
+                         __global float *C) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'vector_add' is estimated to use 1 DSP block, 3600 ALMs and 12 RAM blocks, with an initiation interval of 1 [fpga-kernel-report]
+  int i = get_global_id(0);
+  C[i] = A[i] + B[i];
+}
+
+__kernel void dot_product(__global const float *A, __global const float *B,
+                          __global float *Out) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'dot_product' is estimated to use 2 DSP blocks, 3616 ALMs and 12 RAM blocks, with an initiation interval of 4 [fpga-kernel-report]
+  float Sum = 0.0f;
+  for (int i = 0; i < 1024; ++i)
+    Sum += A[i] * B[i];
+  *Out = Sum;
+}
+
+// CHECK-JSON:      "file": "{{.*}}fpga-kernel-report-directory-option.cpp{{.*}}",
+// CHECK-JSON-NEXT: "kernels": [
+// CHECK-JSON:        "estimate": {
+// CHECK-JSON-NEXT:     "alm": 3600,
+// CHECK-JSON-NEXT:     "dsp": 1,
+// CHECK-JSON-NEXT:     "ii": 1,
+// CHECK-JSON-NEXT:     "ram": 12
+// CHECK-JSON-NEXT:   },
+// CHECK-JSON-NEXT:   "execution-model": "ndrange",
+// CHECK-JSON-NEXT:   "file": "{{.*}}",
+// CHECK-JSON-NEXT:   "line": 5,
+// CHECK-JSON-NEXT:   "loop-nests": 0,
+// CHECK-JSON-NEXT:   "loops": [],
+// CHECK-JSON-NEXT:   "max-loop-depth": 0,
+// CHECK-JSON-NEXT:   "memory": {
+// CHECK-JSON-NEXT:     "global-loads": 2,
+// CHECK-JSON-NEXT:     "global-stores": 1,
+// CHECK-JSON-NEXT:     "local-loads": 0,
+// CHECK-JSON-NEXT:     "local-stores": 0
+// CHECK-JSON-NEXT:   },
+// CHECK-JSON-NEXT:   "name": "vector_add",
+// CHECK-JSON:        "float-add": 1,
+// CHECK-JSON:        "estimate": {
+// CHECK-JSON-NEXT:     "alm": 3616,
+// CHECK-JSON-NEXT:     "dsp": 2,
+// CHECK-JSON-NEXT:     "ii": 4,
+// CHECK-JSON-NEXT:     "ram": 12
+// CHECK-JSON-NEXT:   },
+// CHECK-JSON-NEXT:   "execution-model": "single-work-item",
+// CHECK-JSON-NEXT:   "file": "{{.*}}",
+// CHECK-JSON-NEXT:   "line": 12,
+// CHECK-JSON-NEXT:   "loop-nests": 1,
+// CHECK-JSON-NEXT:   "loops": [
+// CHECK-JSON-NEXT:     {
+// CHECK-JSON-NEXT:       "depth": 1,
+// CHECK-JSON-NEXT:       "ii": 4,
+// CHECK-JSON-NEXT:       "line": 16,
+// CHECK-JSON-NEXT:       "trip-count": 1024,
+// CHECK-JSON-NEXT:       "unroll": null
+// CHECK-JSON-NEXT:     }
+// CHECK-JSON-NEXT:   ],
+// CHECK-JSON-NEXT:   "max-loop-depth": 1,
+// CHECK-JSON:        "name": "dot_product",
@@ -0,0 +1,39 @@
+// RUN: %check_clang_tidy %s fpga-kernel-report %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__kernel void vector_add(__global const float *A, __global const float *B,
+                         __global float *C) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'vector_add' is estimated to use 1 DSP block, 3600 ALMs and 12 RAM blocks, with an initiation interval of 1 [fpga-kernel-report]
+  int i = get_global_id(0);
+  C[i] = A[i] + B[i];
+}
+
+// The accumulation into Sum waits for the previous floating-point addition.
+__kernel void dot_product(__global const float *A, __global const float *B,
+                          __global float *Out) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'dot_product' is estimated to use 2 DSP blocks, 3616 ALMs and 12 RAM blocks, with an initiation interval of 4 [fpga-kernel-report]
+  float Sum = 0.0f;
+  for (int i = 0; i < 1024; ++i)
+    Sum += A[i] * B[i];
+  *Out = Sum;
+}
+
+float scale(float Value) {
+  return Value * 2.0f;
+}
+
+// Unrolling replicates the operations and memory accesses of the loop, and
+// the calls are inlined. Table is replicated to serve its four reads.
+__kernel void lookup(__global const int *In, __global float *Out) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'lookup' is estimated to use 4 DSP blocks, 11064 ALMs and 44 RAM blocks, with an initiation interval of 1 [fpga-kernel-report]
+  __local int Table[1024];
+  Table[get_local_id(0)] = In[get_global_id(0)];
+  barrier(CLK_LOCAL_MEM_FENCE);
+#pragma unroll 4
+  for (int i = 0; i < 16; ++i)
+    Out[i] = scale(Table[In[i]]);
+}
+
+// Functions that are not kernels are not reported on their own.
+void helper(__global int *A) {
+  A[0] = 1;
+}
@@ -0,0 +1,59 @@
+// RUN: %check_clang_tidy %s fpga-local-memory-bank-conflict %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__kernel void replicated(__global float *Out) {
+  __local float Tile[256];
+  // CHECK-FIXES: __local float Tile[256] __attribute__((numbanks(2), bankwidth(4)));
+  Tile[get_local_id(0)] = 0.0f;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int i = 0; i < 256; i += 4) {
+#pragma unroll
+    for (int j = 0; j < 4; ++j)
+      Out[i + j] = Tile[i + j];
+    // CHECK-MESSAGES: :[[@LINE-1]]:20: warning: local memory 'Tile' is accessed by 4 reads and 0 writes per loop iteration, but a memory bank only has 2 ports; the compiler will replicate it 2 times [fpga-local-memory-bank-conflict]
+    // CHECK-MESSAGES: :[[@LINE-9]]:17: note: declare 'Tile' with 2 banks to serve these accesses from separate banks
+  }
+}
+
+__kernel void partially_unrolled(__global float *Out, int N) {
+  __local float Buffer[64];
+  // CHECK-FIXES: __local float Buffer[64] __attribute__((numbanks(2), bankwidth(4)));
+  float Sum = 0.0f;
+#pragma unroll 4
+  for (int i = 0; i < N; ++i)
+    Sum += Buffer[i];
+  // CHECK-MESSAGES: :[[@LINE-1]]:12: warning: local memory 'Buffer' is accessed by 4 reads and 0 writes per loop iteration, but a memory bank only has 2 ports; the compiler will replicate it 2 times [fpga-local-memory-bank-conflict]
+  // CHECK-MESSAGES: :[[@LINE-7]]:17: note: declare 'Buffer' with 2 banks to serve these accesses from separate banks
+  Out[0] = Sum;
+}
+
+__kernel void arbitrated(__global const int *Index) {
+  __local int Histogram[64];
+  for (int i = 0; i < 64; ++i) {
+    Histogram[Index[i]] += 1;
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: local memory 'Histogram' is accessed by 1 read and 2 writes per loop iteration, but a memory bank only has 2 ports; the compiler will arbitrate between the accesses, which stalls the pipeline [fpga-local-memory-bank-conflict]
+    // CHECK-MESSAGES: :[[@LINE-4]]:15: note: consider partitioning 'Histogram' into separate arrays, or reducing the unroll factor
+    Histogram[i] = 0;
+  }
+}
+
+// Already banked
+__kernel void banked(__global float *Out) {
+  __local float Tile[256] __attribute__((numbanks(4), bankwidth(4)));
+  for (int i = 0; i < 256; i += 4) {
+#pragma unroll
+    for (int j = 0; j < 4; ++j)
+      Out[i + j] = Tile[i + j];
+  }
+}
+
+// Enough ports
+__kernel void dual_port(__global float *Out, int N) {
+  __local float Tile[256];
+  for (int i = 0; i < N; ++i)
+    Out[i] = Tile[i] + Tile[i + 1];
+
+  __private float Private[16];
+#pragma unroll
+  for (int i = 0; i < 16; ++i)
+    Private[i] = 0.0f;
+}
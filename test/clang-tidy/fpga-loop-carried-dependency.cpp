@@ -0,0 +1,154 @@
+// RUN: %check_clang_tidy %s fpga-loop-carried-dependency %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__kernel void memory_dependencies(__global float *A, __global const int *Index, int N) {
+  __local float L[256];
+
+  for (int i = 1; i < N; ++i) {
+    A[i] = A[i - 1] * 2.0f;
+    // CHECK-MESSAGES: :[[@LINE-1]]:12: warning: loop-carried dependency through 'A': an element written in one iteration is read 1 iteration later, which limits the initiation interval to about 100; keep the last 1 value in a shift register instead of reading them back from memory [fpga-loop-carried-dependency]
+    // CHECK-MESSAGES: :[[@LINE-2]]:5: note: 'A' is written here
+  }
+
+  for (int i = 0; i < N; i += 2) {
+    A[2 * i] = A[2 * i - 8] + 1.0f;
+    // CHECK-MESSAGES: :[[@LINE-1]]:16: warning: loop-carried dependency through 'A': an element written in one iteration is read 2 iterations later, which limits the initiation interval to about 50; keep the last 2 values in a shift register instead of reading them back from memory [fpga-loop-carried-dependency]
+    // CHECK-MESSAGES: :[[@LINE-2]]:5: note: 'A' is written here
+  }
+
+  for (int i = 2; i < 256; i++) {
+    L[i] += L[i - 2];
+    // CHECK-MESSAGES: :[[@LINE-1]]:13: warning: loop-carried dependency through 'L': an element written in one iteration is read 2 iterations later, which limits the initiation interval to about 3; keep the last 2 values in a shift register instead of reading them back from memory [fpga-loop-carried-dependency]
+    // CHECK-MESSAGES: :[[@LINE-2]]:5: note: 'L' is written here
+  }
+
+  int k = 255;
+  while (k > 8) {
+    L[k - 8] = L[k];
+    k--;
+  }
+
+  for (int i = 0; i < N; ++i) {
+    A[Index[i]] = 1.0f;
+    A[i] = A[i + N];
+    // CHECK-MESSAGES: :[[@LINE-1]]:12: warning: possible loop-carried dependency through 'A' with an unknown distance; if the elements written and read in different iterations never overlap, use '#pragma ivdep' [fpga-loop-carried-dependency]
+    // CHECK-MESSAGES: :[[@LINE-3]]:5: note: 'A' is written here
+  }
+
+  // The distance is large enough to hide the latency of the memory
+  for (int i = 0; i < N; ++i) {
+    A[i + 200] = A[i] + 1.0f;
+  }
+
+  // The element is read before it is overwritten
+  for (int i = 0; i < N; ++i) {
+    A[i] = A[i + 1];
+  }
+
+  // The element is read in the same iteration
+  for (int i = 0; i < N; ++i) {
+    A[i] = A[i] * A[i];
+  }
+
+  // Another iteration may update the same element
+  for (int i = 0; i < N; ++i) {
+    A[Index[i]] += 1.0f;
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: possible loop-carried dependency through 'A' with an unknown distance; if the elements written and read in different iterations never overlap, use '#pragma ivdep' [fpga-loop-carried-dependency]
+  }
+
+  #pragma ivdep
+  for (int i = 0; i < N; ++i) {
+    A[Index[i]] += 1.0f;
+  }
+
+  #pragma clang loop vectorize(assume_safety)
+  for (int i = 0; i < N; ++i) {
+    A[Index[i]]++;
+  }
+
+  // Fully unrolled loops are not pipelined
+  #pragma unroll
+  for (int i = 1; i < 16; ++i) {
+    L[i] = L[i - 1] + 1.0f;
+  }
+}
+
+__kernel void scalar_recurrences(__global const float *A, __global float *B, int N) {
+  float Sum = 0.0f;
+  for (int i = 0; i < N; ++i) {
+    Sum += A[i];
+    // CHECK-MESSAGES: :[[@LINE-1]]:9: warning: floating-point accumulation into 'Sum' is a loop-carried dependency through 1 operation, which limits the initiation interval to about 4; accumulate 4 partial results in a shift register and add them up after the loop [fpga-loop-carried-dependency]
+  }
+  B[0] = Sum;
+  // CHECK-FIXES: float Sum = 0.0f;
+  // CHECK-FIXES-NEXT: float SumPartial[5] = {0};
+  // CHECK-FIXES-NEXT: for (int i = 0; i < N; ++i) {
+  // CHECK-FIXES-NEXT: SumPartial[4] = SumPartial[0] + A[i];
+  // CHECK-FIXES-NEXT: #pragma unroll
+  // CHECK-FIXES-NEXT: for (int SumIndex = 0; SumIndex < 4; ++SumIndex)
+  // CHECK-FIXES-NEXT: SumPartial[SumIndex] = SumPartial[SumIndex + 1];
+  // CHECK-FIXES: #pragma unroll
+  // CHECK-FIXES-NEXT: for (int SumIndex = 0; SumIndex < 4; ++SumIndex)
+  // CHECK-FIXES-NEXT: Sum += SumPartial[SumIndex];
+  // CHECK-FIXES-NEXT: B[0] = Sum;
+
+  float X = 1.0f;
+  for (int i = 0; i < N; ++i) {
+    X = X * A[i] + 1.0f;
+    // CHECK-MESSAGES: :[[@LINE-1]]:7: warning: floating-point accumulation into 'X' is a loop-carried dependency through 2 operations, which limits the initiation interval to about 8; accumulate 8 partial results in a shift register and add them up after the loop [fpga-loop-carried-dependency]
+  }
+  B[1] = X;
+
+  // Integer accumulations complete in a single cycle
+  int Count = 0;
+  for (int i = 0; i < N; ++i) {
+    Count += A[i] > 0.0f;
+  }
+  B[2] = Count;
+
+  // Variables declared in the loop do not carry a value between iterations
+  for (int i = 0; i < N; ++i) {
+    float Y = A[i];
+    Y = Y * 2.0f;
+    B[i] = Y;
+  }
+
+  // Accumulations that do not read the previous value are not recurrences
+  float Last = 0.0f;
+  for (int i = 0; i < N; ++i) {
+    Last = A[i] * 2.0f;
+  }
+  B[3] = Last;
+}
+
+__kernel void dot_product(__global const float *A, __global const float *B,
+                          __global float *Out, int N) {
+  float Dot = 0.0f;
+  #pragma ii 1
+  for (int i = 0; i < N; ++i) {
+    Dot = Dot + A[i] * B[i];
+    // CHECK-MESSAGES: :[[@LINE-1]]:9: warning: floating-point accumulation into 'Dot' is a loop-carried dependency through 1 operation, which limits the initiation interval to about 4; accumulate 4 partial results in a shift register and add them up after the loop [fpga-loop-carried-dependency]
+  }
+  *Out = Dot;
+  // CHECK-FIXES: float Dot = 0.0f;
+  // CHECK-FIXES-NEXT: float DotPartial[5] = {0};
+  // CHECK-FIXES-NEXT: #pragma ii 1
+  // CHECK-FIXES-NEXT: for (int i = 0; i < N; ++i) {
+  // CHECK-FIXES-NEXT: DotPartial[4] = DotPartial[0] + A[i] * B[i];
+  // CHECK-FIXES-NEXT: #pragma unroll
+  // CHECK-FIXES-NEXT: for (int DotIndex = 0; DotIndex < 4; ++DotIndex)
+  // CHECK-FIXES-NEXT: DotPartial[DotIndex] = DotPartial[DotIndex + 1];
+  // CHECK-FIXES: #pragma unroll
+  // CHECK-FIXES-NEXT: for (int DotIndex = 0; DotIndex < 4; ++DotIndex)
+  // CHECK-FIXES-NEXT: Dot += DotPartial[DotIndex];
+  // CHECK-FIXES-NEXT: *Out = Dot;
+}
+
+// The sum is read in the loop, so it cannot be split into partial sums.
+__kernel void running_sum(__global const float *A, __global float *B, int N) {
+  float Sum = 0.0f;
+  for (int i = 0; i < N; ++i) {
+    Sum += A[i];
+    // CHECK-MESSAGES: :[[@LINE-1]]:9: warning: floating-point accumulation into 'Sum' is a loop-carried dependency
+    B[i] = Sum;
+  }
+}
@@ -0,0 +1,62 @@
+// RUN: %check_clang_tidy %s fpga-private-array-registers %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__kernel void fir(__global const float *In, __global float *Out, int N) {
+  float Taps[8] = {0.0f};
+  // CHECK-MESSAGES: :[[@LINE-1]]:9: warning: private array 'Taps' is implemented in block RAM instead of registers because it is indexed with values that are not constant after unrolling; fully unrolling the loops noted below would let it live in registers [fpga-private-array-registers]
+  for (int i = 0; i < N; ++i) {
+    #pragma unroll
+    for (int j = 7; j > 0; --j)
+      Taps[j] = Taps[j - 1];
+    Taps[0] = In[i];
+    float Sum = 0.0f;
+    for (int j = 0; j < 8; ++j)
+      Sum += Taps[j];
+    // CHECK-MESSAGES: :[[@LINE-1]]:19: note: index depends on 'j', the counter of a loop with 8 iterations that is not fully unrolled
+    Out[i] = Sum;
+  }
+}
+
+__kernel void shift(__global const float *In, __global float *Out, int N) {
+  float Window[16];
+  for (int i = 0; i < N; ++i) {
+    #pragma unroll
+    for (int j = 0; j < 15; ++j)
+      Window[j] = Window[j + 1];
+    Window[15] = In[i];
+    float Sum = 0.0f;
+    #pragma unroll 16
+    for (int j = 0; j < 16; ++j) {
+      const int k = 15 - j;
+      Sum += Window[k];
+    }
+    Out[i] = Sum;
+  }
+}
+
+__kernel void histogram(__global const int *In, __global int *Out, int N) {
+  int Bins[4][16];
+  // CHECK-MESSAGES: :[[@LINE-1]]:7: warning: private array 'Bins' is implemented in block RAM instead of registers because it is indexed with values that are not constant after unrolling [fpga-private-array-registers]
+  for (int i = 0; i < N; ++i)
+    Bins[i % 4][In[i]]++;
+  // CHECK-MESSAGES: :[[@LINE-1]]:10: note: index depends on 'i', the counter of a loop that cannot be fully unrolled
+  #pragma unroll
+  for (int b = 0; b < 16; ++b)
+    Out[b] = Bins[0][b] + Bins[1][b] + Bins[2][b] + Bins[3][b];
+}
+
+__kernel void choose(__global const float *In, __global float *Out, int K) {
+  float Values[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  // CHECK-MESSAGES: :[[@LINE-1]]:9: warning: private array 'Values' is implemented in block RAM
+  Out[get_global_id(0)] = Values[K] + Values[In[0]];
+  // CHECK-MESSAGES: :[[@LINE-1]]:34: note: index depends on 'K', which is not known at compile time
+  // CHECK-MESSAGES: :[[@LINE-2]]:46: note: index is computed from a call or a memory access
+}
+
+void fill(float *Buffer);
+
+// The array escapes to a function.
+__kernel void escape(__global float *Out) {
+  float Buffer[8];
+  fill(Buffer);
+  Out[get_global_id(0)] = Buffer[get_global_id(0) % 8];
+}
@@ -33,6 +33,30 @@ void __kernel success_barrier_both_ids(__global int * foo, int size) {
   int lid = get_local_id(0);
 }
 
+void sync_helper() {
+  barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+void __kernel error_barrier_in_helper_no_id(__global int * foo) {
+  foo[0] = 1;
+  sync_helper();
+}
+// CHECK-MESSAGES-OLD: :[[@LINE-4]]:15: warning: Kernel function 'error_barrier_in_helper_no_id' does not call get_global_id or get_local_id and will be treated as single-work-item.{{[[:space:]]}}Barrier call at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-7]]:3 may error out [fpga-single-work-item-barrier]
+
+int get_id_helper() {
+  return get_global_id(0);
+}
+
+void __kernel success_barrier_id_in_helper(__global int * foo) {
+  barrier(CLK_GLOBAL_MEM_FENCE);
+  foo[get_id_helper()] = 0;
+}
+
+void __kernel success_barrier_group_id(__global int * foo) {
+  barrier(CLK_GLOBAL_MEM_FENCE);
+  foo[get_group_id(0)] = 0;
+}
+
 void success_nokernel_barrier_no_id(__global int * foo, int size) {
   for (int j = 0; j < 256; j++) {
 	for (int i = 256; i < size; i+= 256) {
@@ -0,0 +1,18 @@
+// RUN: %check_clang_tidy %s fpga-struct-pack-align %t \
+// RUN: -config="{CheckOptions: [ \
+// RUN:   {key: "fpga-struct-pack-align.BankWidth", value: 32}, \
+// RUN:   {key: "fpga-struct-pack-align.BurstSize", value: 4} \
+// RUN: ]}" \
+// RUN: -header-filter=.* "--" --include opencl-c.h -cl-std=CL1.2 -c
+
+struct sample {
+  double a[3];
+};
+// CHECK-MESSAGES: :[[@LINE-3]]:8: warning: struct 'sample' has inefficient access due to poor alignment. Currently aligned to 8 bytes, but size 24 bytes is large enough to benefit from "__attribute((aligned(32)))" [fpga-struct-pack-align]
+// CHECK-MESSAGES: :[[@LINE-4]]:8: note: aligned to 32 bytes, an access to 'sample' transfers 24 useful bytes per 32-byte memory transaction instead of 12, and a 128-byte burst holds 4 of them
+
+// Not aligned beyond the width of an HBM pseudo-channel, and aligning it to
+// 32 bytes would not save a memory word per access
+struct wide {
+  double a[5];
+};
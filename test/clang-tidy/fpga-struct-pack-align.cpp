@@ -6,8 +6,13 @@ char a;
 double b;
 char c;
 };
-// CHECK-MESSAGES: :[[@LINE-5]]:8: warning: struct 'error' has inefficient access due to padding, only needs 10 bytes but is using 24 bytes, use "__attribute((packed))" [fpga-struct-pack-align]
+// CHECK-MESSAGES: :[[@LINE-5]]:8: warning: struct 'error' has inefficient access due to padding, only needs 10 bytes but is using 24 bytes; reordering its fields by alignment reduces it to 16 bytes without packing [fpga-struct-pack-align]
 // CHECK-MESSAGES: :[[@LINE-6]]:8: warning: struct 'error' has inefficient access due to poor alignment. Currently aligned to 8 bytes, but size 10 bytes is large enough to benefit from "__attribute((aligned(16)))" [fpga-struct-pack-align]
+// CHECK-MESSAGES: :[[@LINE-7]]:8: note: aligned to 16 bytes, an access to 'error' transfers 10 useful bytes per 64-byte memory transaction instead of 5, and a 1024-byte burst holds 64 of them
+// CHECK-FIXES: {{^}}struct error {
+// CHECK-FIXES-NEXT: {{^}}double b;{{$}}
+// CHECK-FIXES-NEXT: {{^}}char a;{{$}}
+// CHECK-FIXES-NEXT: {{^}}char c;{{$}}
 
 // Struct is explicitly packed, but needs alignment
 struct error_packed {
@@ -65,10 +70,40 @@ int b;
 int c;
 } __attribute((aligned(16)));
 
-// If struct is properly aligned, packing not needed
+// If struct is properly aligned, packing not needed, but reordering its fields
+// halves its size
 struct error_aligned {
 char a;
 double b;
 char c;
 } __attribute((aligned(16)));
+// CHECK-MESSAGES: :[[@LINE-5]]:8: warning: struct 'error_aligned' has inefficient access due to padding, only needs 10 bytes but is using 32 bytes; reordering its fields by alignment reduces it to 16 bytes without packing [fpga-struct-pack-align]
+// CHECK-FIXES: {{^}}struct error_aligned {
+// CHECK-FIXES-NEXT: {{^}}double b;{{$}}
+// CHECK-FIXES-NEXT: {{^}}char a;{{$}}
+// CHECK-FIXES-NEXT: {{^}}char c;{{$}}
 
+// Initializer lists are reordered along with the fields
+struct reordered {
+  char a;
+  int b;
+  char c;
+};
+// CHECK-MESSAGES: :[[@LINE-5]]:8: warning: struct 'reordered' has inefficient access due to padding, only needs 6 bytes but is using 12 bytes; reordering its fields by alignment reduces it to 8 bytes without packing [fpga-struct-pack-align]
+// CHECK-MESSAGES: :[[@LINE-6]]:8: warning: struct 'reordered' has inefficient access due to poor alignment. Currently aligned to 4 bytes, but size 6 bytes is large enough to benefit from "__attribute((aligned(8)))" [fpga-struct-pack-align]
+// CHECK-FIXES: {{^}}  int b;{{$}}
+// CHECK-FIXES-NEXT: {{^}}  char a;{{$}}
+// CHECK-FIXES-NEXT: {{^}}  char c;{{$}}
+
+__constant struct reordered Table = {1, 2, 3};
+// CHECK-FIXES: {{^}}__constant struct reordered Table = {2, 1, 3};{{$}}
+
+// Bit-fields are not reordered
+struct bit_fields {
+  char a;
+  int b : 4;
+  int c;
+  char d;
+};
+// CHECK-MESSAGES: :[[@LINE-6]]:8: warning: struct 'bit_fields' has inefficient access due to padding, only needs 10 bytes but is using 12 bytes, use "__attribute((packed))" [fpga-struct-pack-align]
+// CHECK-MESSAGES: :[[@LINE-7]]:8: warning: struct 'bit_fields' has inefficient access due to poor alignment. Currently aligned to 4 bytes, but size 10 bytes is large enough to benefit from "__attribute((aligned(16)))" [fpga-struct-pack-align]
@@ -0,0 +1,47 @@
+// RUN: %check_clang_tidy %s fpga-trivial-ndrange-kernel %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__kernel void scale(__global float *Data, float Factor) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: NDRange kernel 'scale' only uses the work-item ID as get_global_id(0); consider converting it into a single-work-item kernel that loops over the work-items, which the compiler can pipeline [fpga-trivial-ndrange-kernel]
+  int i = get_global_id(0);
+  // CHECK-MESSAGES: :[[@LINE-1]]:11: note: the work-item ID is read here
+  Data[i] *= Factor;
+}
+
+int item_index() {
+  return get_global_id(0);
+}
+
+// The ID is read in a helper function.
+__kernel void copy(__global const int *In, __global int *Out) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: NDRange kernel 'copy' only uses
+  Out[item_index()] = In[item_index()];
+}
+
+// Already a single-work-item kernel.
+__kernel void loop(__global float *Data, int N) {
+  for (int i = 0; i < N; ++i)
+    Data[i] *= 2.0f;
+}
+
+__kernel void two_dimensions(__global float *Data) {
+  Data[get_global_id(1) * 16 + get_global_id(0)] = 0.0f;
+}
+
+__kernel void group(__global float *Data) {
+  Data[get_group_id(0)] = 0.0f;
+}
+
+__kernel void global_size(__global float *Data) {
+  Data[get_global_id(0)] = get_global_size(0);
+}
+
+__kernel void synchronized(__global float *Data, __local float *Scratch) {
+  Scratch[get_local_id(0)] = Data[get_global_id(0)];
+  barrier(CLK_LOCAL_MEM_FENCE);
+  Data[get_global_id(0)] = Scratch[0];
+}
+
+__attribute__((reqd_work_group_size(64, 1, 1)))
+__kernel void work_group_size(__global float *Data) {
+  Data[get_global_id(0)] = 0.0f;
+}
@@ -295,6 +295,234 @@ __kernel void unrolled_nested_simple_loops_large_num_iterations(__global int *A)
     } while (i < 1000);
 }
 
+#define NUM_ITERATIONS 40
+
+// The trip count is computed from the initial value, step and bound
+__kernel void unrolled_loops_trip_count(__global int *A) {
+    #pragma unroll
+    for (int i = 8; i < 4096; i += 128) {
+        A[0] += i;
+    }
+
+    #pragma unroll
+    for (int i = 0; i <= 50; i++) {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: This loop likely has a large number of iterations and thus cannot be fully unrolled. To partially unroll this loop, use the #pragma unroll <num> directive [fpga-unroll-loops]
+// CHECK-MESSAGES: :[[@LINE-2]]:5: note: unrolling this loop by a factor of 17 replicates 34 operations
+// CHECK-FIXES: {{^}}    #pragma unroll 17{{$}}
+// CHECK-FIXES-NEXT: {{^}}    for (int i = 0; i <= 50; i++) {
+        A[1] += i;
+    }
+
+    int i;
+    #pragma unroll
+    for (i = 100; i > 60; i--) {
+        A[2] += i;
+    }
+
+    #pragma unroll
+    for (i = 100; i >= 0; i -= 2) {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: This loop likely has a large number of iterations and thus cannot be fully unrolled. To partially unroll this loop, use the #pragma unroll <num> directive [fpga-unroll-loops]
+        A[3] += i;
+    }
+
+    #pragma unroll
+    for (i = 0; i != 160; i += 4) {
+        A[4] += i;
+    }
+
+    #pragma unroll
+    for (i = 0; i < NUM_ITERATIONS * 2; i = i + 2) {
+        A[5] += i;
+    }
+
+    const int Bound = 1000;
+    #pragma unroll
+    for (i = 960; Bound > i; ++i) {
+        A[6] += i;
+    }
+
+    int j = 0;
+    #pragma unroll
+    while (j < 4000) {
+        A[7] += j;
+        j += 100;
+    }
+
+    j = 200;
+    #pragma unroll
+    do {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: This loop likely has a large number of iterations and thus cannot be fully unrolled. To partially unroll this loop, use the #pragma unroll <num> directive [fpga-unroll-loops]
+        A[8] += j;
+        j--;
+    } while (j > 149);
+
+    #pragma clang loop unroll(full)
+    for (i = 0; i <= 50; i++) {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: This loop likely has a large number of iterations and thus cannot be fully unrolled. To partially unroll this loop, use the #pragma unroll <num> directive [fpga-unroll-loops]
+// CHECK-MESSAGES: :[[@LINE-2]]:5: note: unrolling this loop by a factor of 17 replicates 34 operations
+// CHECK-FIXES: {{^}}    #pragma clang loop unroll_count(17){{$}}
+// CHECK-FIXES-NEXT: {{^}}    for (i = 0; i <= 50; i++) {
+        A[9] += i;
+    }
+}
+
+// The recommended factor is the largest divisor of the trip count that stays
+// within the budget of replicated operations
+__kernel void recommended_unroll_factor(__global int *A) {
+    for (int i = 0; i < 1000; ++i) {
+        for (int j = 0; j < 12; ++j) {
+// CHECK-MESSAGES: :[[@LINE-1]]:9: warning: The performance of the kernel could be improved by unrolling this loop with a #pragma unroll directive [fpga-unroll-loops]
+// CHECK-MESSAGES: :[[@LINE-2]]:9: note: unrolling this loop by a factor of 12 replicates 36 operations
+// CHECK-FIXES: {{^}}        #pragma unroll{{$}}
+// CHECK-FIXES-NEXT: {{^}}        for (int j = 0; j < 12; ++j) {
+            A[j] += i * j;
+        }
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        for (int j = 0; j < 1000; ++j) {
+// CHECK-MESSAGES: :[[@LINE-1]]:9: warning: The performance of the kernel could be improved by unrolling this loop with a #pragma unroll directive [fpga-unroll-loops]
+// CHECK-MESSAGES: :[[@LINE-2]]:9: note: unrolling this loop by a factor of 25 replicates 100 operations
+// CHECK-FIXES: {{^}}        #pragma unroll 25{{$}}
+// CHECK-FIXES-NEXT: {{^}}        for (int j = 0; j < 1000; ++j) {
+            A[j] = A[j] * 3 + i;
+        }
+    }
+
+    // The directive needs a line of its own
+    for (int i = 0; i < 1000; ++i) {
+        A[i] = 0; for (int j = 0; j < 12; ++j) {
+// CHECK-MESSAGES: :[[@LINE-1]]:19: warning: The performance of the kernel could be improved by unrolling this loop with a #pragma unroll directive [fpga-unroll-loops]
+// CHECK-MESSAGES: :[[@LINE-2]]:19: note: unrolling this loop by a factor of 12 replicates 36 operations
+// CHECK-FIXES: {{^}}    for (int i = 0; i < 1000; ++i) {
+// CHECK-FIXES-NEXT: {{^}}        A[i] = 0; for (int j = 0; j < 12; ++j) {
+            A[j] += i * j;
+        }
+    }
+}
+
+// Unrolling an outer loop replicates its whole nest
+__kernel void unrolled_loop_nests(__global int *A) {
+    #pragma unroll
+    for (int i = 0; i < 4; ++i) {
+        #pragma unroll
+        for (int j = 0; j < 8; ++j) {
+            A[i * 8 + j] += i;
+        }
+    }
+
+    #pragma unroll
+    for (int i = 0; i < 8; ++i) {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Fully unrolling this loop nest replicates its innermost body 64 times, which likely exceeds the available area. Consider pipelining this loop instead, and unrolling only its inner loops [fpga-unroll-loops]
+        #pragma unroll
+        for (int j = 0; j < 8; ++j) {
+            A[i * 8 + j] += i;
+        }
+    }
+
+    #pragma unroll
+    for (int i = 0; i < 4; ++i) {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Fully unrolling this loop nest replicates its innermost body 72 times, which likely exceeds the available area. Consider pipelining this loop instead, and unrolling only its inner loops [fpga-unroll-loops]
+        #pragma unroll
+        for (int j = 0; j < 8; ++j) {
+            A[j] += i;
+        }
+        #pragma unroll
+        for (int k = 0; k < 10; ++k) {
+            A[k] -= i;
+        }
+    }
+
+    #pragma unroll 2
+    for (int i = 0; i < 1000; ++i) {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Unrolling this loop replicates the pipelines of its inner loops, which are not fully unrolled. Consider pipelining this loop instead, and unrolling its inner loops [fpga-unroll-loops]
+        for (int j = 0; j < 1000; ++j) {
+// CHECK-MESSAGES: :[[@LINE-1]]:9: warning: The performance of the kernel could be improved by unrolling this loop with a #pragma unroll directive [fpga-unroll-loops]
+            A[j] += i;
+        }
+    }
+
+    // The outer loop is pipelined, and its inner loop is fully unrolled
+    for (int i = 0; i < 1000; ++i) {
+        #pragma unroll
+        for (int j = 0; j < 16; ++j) {
+            A[j] += i;
+        }
+    }
+}
+
+// Loop pragmas that control the pipeline interact with unrolling
+__kernel void loop_pragmas(__global int *A) {
+    // The pipeline of these loops is tuned explicitly, so they are not
+    // expected to be unrolled
+    #pragma ii 1
+    for (int i = 0; i < 1000; ++i) {
+        A[i] += i;
+    }
+
+    int i = 0;
+    #pragma max_concurrency 2
+    while (i < 1000) {
+        A[i] += i;
+        i++;
+    }
+
+    #pragma nounroll
+    for (int i = 0; i < 1000; ++i) {
+        A[i] += i;
+    }
+
+    #pragma ii 2
+    #pragma unroll
+    for (int i = 0; i < 10; ++i) {
+// CHECK-MESSAGES: :[[@LINE-3]]:5: warning: #pragma ii has no effect on a fully unrolled loop, which is not pipelined [fpga-unroll-loops]
+        A[i] += i;
+    }
+
+    #pragma unroll
+    #pragma speculated_iterations 0
+    for (int i = 0; i < 10; ++i) {
+// CHECK-MESSAGES: :[[@LINE-2]]:5: warning: #pragma speculated_iterations has no effect on a fully unrolled loop, which is not pipelined [fpga-unroll-loops]
+        A[i] += i;
+    }
+
+    #pragma ivdep
+    #pragma unroll 4
+    for (int i = 0; i < 1000; ++i) {
+        A[i] += A[i + 1];
+    }
+
+    #pragma ivdep
+    for (int i = 0; i < 1000; ++i) {
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: The performance of the kernel could be improved by unrolling this loop with a #pragma unroll directive [fpga-unroll-loops]
+        A[i] += A[i + 1];
+    }
+
+    #pragma loop_coalesce 2
+    for (int i = 0; i < 1000; ++i) {
+        #pragma unroll 4
+        for (int j = 0; j < 1000; ++j) {
+            A[j] += i;
+        }
+    }
+
+    #pragma loop_coalesce 3
+    for (int i = 0; i < 1000; ++i) {
+// CHECK-MESSAGES: :[[@LINE-2]]:5: warning: #pragma loop_coalesce 3 coalesces more loops than the 2 this loop nest contains [fpga-unroll-loops]
+        #pragma unroll 4
+        for (int j = 0; j < 1000; ++j) {
+            A[j] += i;
+        }
+    }
+
+    #pragma loop_coalesce
+    #pragma unroll 4
+    for (int i = 0; i < 1000; ++i) {
+// CHECK-MESSAGES: :[[@LINE-3]]:5: warning: #pragma loop_coalesce has no effect on a loop that does not contain nested loops [fpga-unroll-loops]
+        A[i] += i;
+    }
+}
+
 __kernel void fully_unrolled_unknown_bounds(int vectorSize) {
     int someVector[101];
 
@@ -356,4 +584,3 @@ __kernel void fully_unrolled_unknown_bounds(int vectorSize) {
         printf("%d", someVector);
     } while (j < vectorSize);
 }
-// There are no fix-its for this check
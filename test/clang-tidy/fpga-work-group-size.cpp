@@ -0,0 +1,85 @@
+// RUN: %check_clang_tidy %s fpga-work-group-size %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__kernel void reduce(__global const float *In, __global float *Out) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'reduce' has no reqd_work_group_size attribute, so its hardware is sized for the largest work-group; the __local arrays it indexes with get_local_id suggest a work-group size of (256, 1, 1) [fpga-work-group-size]
+// CHECK-FIXES: __attribute__((reqd_work_group_size(256, 1, 1)))
+// CHECK-FIXES-NEXT: __kernel void reduce(__global const float *In, __global float *Out) {
+  __local float Scratch[256];
+  int Lid = get_local_id(0);
+  Scratch[Lid] = In[get_global_id(0)];
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: note: 'Scratch' is indexed by get_local_id(0) in a dimension of size 256
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int Stride = 128; Stride > 0; Stride /= 2) {
+    if (Lid < Stride)
+      Scratch[Lid] += Scratch[Lid + Stride];
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  if (Lid == 0)
+    Out[get_group_id(0)] = Scratch[0];
+}
+
+// The padding of the tile does not count: the transposed access bounds both
+// dimensions by 16.
+__kernel void transpose(__global const float *In, __global float *Out,
+                        int Width, int Height) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'transpose' has no reqd_work_group_size attribute, so its hardware is sized for the largest work-group; the __local arrays it indexes with get_local_id suggest a work-group size of (16, 16, 1) [fpga-work-group-size]
+// CHECK-FIXES: __attribute__((reqd_work_group_size(16, 16, 1)))
+// CHECK-FIXES-NEXT: __kernel void transpose(__global const float *In, __global float *Out,
+  __local float Tile[16][17];
+  int X = get_local_id(0);
+  int Y = get_local_id(1);
+  Tile[Y][X] = In[get_global_id(1) * Width + get_global_id(0)];
+  barrier(CLK_LOCAL_MEM_FENCE);
+  Out[(get_group_id(0) * 16 + Y) * Height + get_group_id(1) * 16 + X] =
+      Tile[X][Y];
+}
+
+__attribute__((reqd_work_group_size(256, 1, 1)))
+__kernel void sized(__global const float *In, __global float *Out) {
+  __local float Scratch[256];
+  Scratch[get_local_id(0)] = In[get_global_id(0)];
+  barrier(CLK_LOCAL_MEM_FENCE);
+  Out[get_global_id(0)] = Scratch[255 - get_local_id(0)];
+}
+
+__attribute__((max_work_group_size(256)))
+__kernel void bounded(__global const float *In, __global float *Out) {
+  __local float Scratch[256];
+  Scratch[get_local_id(0)] = In[get_global_id(0)];
+  barrier(CLK_LOCAL_MEM_FENCE);
+  Out[get_global_id(0)] = Scratch[255 - get_local_id(0)];
+}
+
+// Only an attribute bounds the work-group size, not a comment.
+__kernel /* max_work_group_size */ void commented(__global const float *In,
+                                                  __global float *Out) {
+// CHECK-MESSAGES: :[[@LINE-2]]:41: warning: kernel 'commented' has no reqd_work_group_size attribute, so its hardware is sized for the largest work-group; the __local arrays it indexes with get_local_id suggest a work-group size of (256, 1, 1) [fpga-work-group-size]
+// CHECK-FIXES: __attribute__((reqd_work_group_size(256, 1, 1)))
+// CHECK-FIXES-NEXT: __kernel /* max_work_group_size */ void commented(__global const float *In,
+  __local float Scratch[256];
+  Scratch[get_local_id(0)] = In[get_global_id(0)];
+  barrier(CLK_LOCAL_MEM_FENCE);
+  Out[get_global_id(0)] = Scratch[255 - get_local_id(0)];
+}
+
+// Nothing tells the size of the second dimension.
+__kernel void rows(__global const float *In, __global float *Out, int Width) {
+  __local float Row[64];
+  Row[get_local_id(0)] = In[get_global_id(1) * Width + get_global_id(0)];
+  barrier(CLK_LOCAL_MEM_FENCE);
+  Out[get_global_id(1) * Width + get_global_id(0)] = Row[0];
+}
+
+// No local memory.
+__kernel void copy(__global const float *In, __global float *Out) {
+  Out[get_global_id(0)] = In[get_global_id(0)];
+}
+
+// Single-work-item kernel.
+__kernel void loop(__global const float *In, __global float *Out, int N) {
+  __local float Buffer[64];
+  for (int i = 0; i < N; ++i) {
+    Buffer[i % 64] = In[i];
+    Out[i] = Buffer[(i + 1) % 64];
+  }
+}
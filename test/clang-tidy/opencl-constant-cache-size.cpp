@@ -0,0 +1,33 @@
+// RUN: %check_clang_tidy %s opencl-constant-cache-size %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__constant float Window[4096] = {1.0f};
+__constant int Offsets[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+__constant int Small[16] = {0};
+
+float window(int i) { return Window[i]; }
+
+__kernel void filter(__global const float *In, __global float *Out,
+                     __constant float *Coefficients) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'filter' reads at least 20512 bytes of __constant data, more than the 16384-byte constant cache holds; consider moving the largest arrays to __local memory or to private ROMs [opencl-constant-cache-size]
+// CHECK-MESSAGES: :3:18: note: 'Window' holds 16384 bytes of __constant data
+// CHECK-MESSAGES: :[[@LINE-4]]:40: note: 'Coefficients' holds at least 4096 bytes of __constant data
+// CHECK-MESSAGES: :4:16: note: 'Offsets' holds 32 bytes of __constant data
+  float Sum = 0.0f;
+  for (int i = 0; i < 1024; ++i)
+    Sum += Coefficients[i] * window(i) * In[get_global_id(0) + Offsets[i % 8]];
+  Out[get_global_id(0)] = Sum;
+}
+
+// The argument is indexed with loaded data, so its size is unknown.
+__kernel void lookup(__global const int *In, __global float *Out,
+                     __constant float *Table) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'lookup' reads at least 16448 bytes of __constant data, more than the 16384-byte constant cache holds
+  Out[get_global_id(0)] = Table[In[get_global_id(0)]] + Window[4095] + Small[0];
+}
+
+__kernel void fits(__global float *Out, __constant float *Taps) {
+  float Sum = 0.0f;
+  for (int i = 0; i < 16; ++i)
+    Sum += Taps[i + 1] * Small[i];
+  Out[get_global_id(0)] = Sum;
+}
@@ -0,0 +1,90 @@
+// RUN: %check_clang_tidy %s opencl-host-serialization %t
+
+typedef __SIZE_TYPE__ size_t;
+typedef int cl_int;
+typedef unsigned int cl_uint;
+typedef unsigned int cl_bool;
+typedef unsigned long cl_mem_flags;
+typedef struct _cl_context *cl_context;
+typedef struct _cl_command_queue *cl_command_queue;
+typedef struct _cl_mem *cl_mem;
+typedef struct _cl_kernel *cl_kernel;
+typedef struct _cl_program *cl_program;
+typedef struct _cl_event *cl_event;
+
+#define CL_FALSE 0
+#define CL_TRUE 1
+#define CL_MEM_READ_WRITE (1 << 0)
+#define NULL 0
+
+cl_int clEnqueueReadBuffer(cl_command_queue, cl_mem, cl_bool, size_t, size_t,
+                           void *, cl_uint, const cl_event *, cl_event *);
+cl_int clEnqueueWriteBuffer(cl_command_queue, cl_mem, cl_bool, size_t, size_t,
+                            const void *, cl_uint, const cl_event *,
+                            cl_event *);
+cl_int clEnqueueNDRangeKernel(cl_command_queue, cl_kernel, cl_uint,
+                              const size_t *, const size_t *, const size_t *,
+                              cl_uint, const cl_event *, cl_event *);
+cl_mem clCreateBuffer(cl_context, cl_mem_flags, size_t, void *, cl_int *);
+cl_kernel clCreateKernel(cl_program, const char *, cl_int *);
+cl_int clSetKernelArg(cl_kernel, cl_uint, size_t, const void *);
+cl_int clFinish(cl_command_queue);
+
+void transfers(cl_command_queue Queue, cl_kernel Kernel, cl_mem Input,
+               cl_mem Output, float *Frames[], float *Results, int N) {
+  size_t Global = 1024;
+  for (int i = 0; i < N; ++i) {
+    clEnqueueWriteBuffer(Queue, Input, CL_TRUE, 0, 4096, Frames[i], 0, NULL,
+                         NULL);
+    // CHECK-MESSAGES: :[[@LINE-2]]:5: warning: blocking 'clEnqueueWriteBuffer' inside a loop stalls the host until the transfer completes; pass CL_FALSE and wait on its event, double-buffering the data so that transfers overlap with the kernels [opencl-host-serialization]
+    clEnqueueNDRangeKernel(Queue, Kernel, 1, NULL, &Global, NULL, 0, NULL,
+                           NULL);
+    clEnqueueReadBuffer(Queue, Output, CL_FALSE, 0, 4096, Results, 0, NULL,
+                        NULL);
+    // The host needs the results of the non-blocking read.
+    clFinish(Queue);
+  }
+  clEnqueueReadBuffer(Queue, Output, CL_TRUE, 0, 4096, Results, 0, NULL, NULL);
+}
+
+void creation(cl_context Context, cl_program Program, const char *Names[],
+              int N) {
+  cl_int Err;
+  for (int i = 0; i < N; ++i) {
+    cl_mem Buffer =
+        clCreateBuffer(Context, CL_MEM_READ_WRITE, 4096, NULL, &Err);
+    // CHECK-MESSAGES: :[[@LINE-1]]:9: warning: 'clCreateBuffer' is called with the same arguments on every iteration of the loop; create the object once before the loop and reuse it [opencl-host-serialization]
+    cl_kernel Scale = clCreateKernel(Program, "scale", &Err);
+    // CHECK-MESSAGES: :[[@LINE-1]]:23: warning: 'clCreateKernel' is called with the same arguments on every iteration of the loop; create the object once before the loop and reuse it [opencl-host-serialization]
+    // Every iteration creates a different kernel.
+    cl_kernel Kernel = clCreateKernel(Program, Names[i], &Err);
+    clSetKernelArg(Kernel, 0, sizeof(cl_mem), &Buffer);
+    clSetKernelArg(Scale, 0, sizeof(cl_mem), &Buffer);
+  }
+}
+
+void finish(cl_command_queue Queue, cl_kernel Kernel, cl_mem Output,
+            float *Results, int N) {
+  size_t Global = 1024;
+  for (int i = 0; i < N; ++i) {
+    clEnqueueNDRangeKernel(Queue, Kernel, 1, NULL, &Global, NULL, 0, NULL,
+                           NULL);
+    clFinish(Queue);
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: clFinish after a kernel launch stalls the host, although the next command on the in-order queue 'Queue' starts after the kernel anyway; wait on the event of the command whose results the host needs instead [opencl-host-serialization]
+    // CHECK-MESSAGES: :[[@LINE-4]]:5: note: next command on 'Queue' is here
+  }
+  clEnqueueReadBuffer(Queue, Output, CL_TRUE, 0, 4096, Results, 0, NULL, NULL);
+  clFinish(Queue);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: redundant clFinish; the host already waited for 'Queue' at the previous blocking command [opencl-host-serialization]
+  // CHECK-MESSAGES: :[[@LINE-3]]:3: note: previous command on 'Queue' is here
+  clFinish(Queue);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: redundant clFinish; the host already waited for 'Queue' at the previous clFinish [opencl-host-serialization]
+  // CHECK-MESSAGES: :[[@LINE-5]]:3: note: previous command on 'Queue' is here
+}
+
+// The host may need the results right after the last launch.
+void single(cl_command_queue Queue, cl_kernel Kernel) {
+  size_t Global = 1024;
+  clEnqueueNDRangeKernel(Queue, Kernel, 1, NULL, &Global, NULL, 0, NULL, NULL);
+  clFinish(Queue);
+}
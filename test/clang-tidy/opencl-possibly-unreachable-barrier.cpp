@@ -65,3 +65,96 @@ __kernel void correct() {
     work_group_barrier(CLK_LOCAL_MEM_FENCE);
   }  
 }
+
+int id_helper(int Value) {
+  return Value * 2;
+}
+
+__kernel void interprocedural_errors() {
+  int n = id_helper(get_local_id(0));
+  if (n < 256) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Barrier inside if/else may not be reachable due to reference to ID-dependent variable 'n' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-2]]:7 [opencl-possibly-unreachable-barrier]
+  }
+  if (id_helper(get_global_id(0)) < 256) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Barrier inside if/else may not be reachable due to ID function call in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-2]]:7 [opencl-possibly-unreachable-barrier]
+  }
+}
+
+__kernel void interprocedural_correct() {
+  int n = id_helper(get_local_size(0));
+  if (n < 256) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+__kernel void jump_errors(__global int *A) {
+  int tid = get_local_id(0);
+  for (int i = 0; i < 16; i++) {
+    if (A[tid] == i)
+      break;
+    barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Barrier inside if/else may not be reachable due to reference to ID-dependent variable 'tid' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-3]]:9 [opencl-possibly-unreachable-barrier]
+  }
+  for (int i = 0; i < 16; i++) {
+    if (tid < i)
+      continue;
+    barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Barrier inside if/else may not be reachable due to reference to ID-dependent variable 'tid' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-3]]:9 [opencl-possibly-unreachable-barrier]
+  }
+  int j = 0;
+  while (j < tid) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Barrier inside while loop may not be reachable due to reference to ID-dependent variable 'tid' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-2]]:10 [opencl-possibly-unreachable-barrier]
+    j++;
+  }
+  switch (tid) {
+  case 0:
+    barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Barrier inside switch may not be reachable due to reference to ID-dependent variable 'tid' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-3]]:11 [opencl-possibly-unreachable-barrier]
+    break;
+  default:
+    break;
+  }
+  if (tid > 32)
+    return;
+  barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:3: warning: Barrier inside if/else may not be reachable due to reference to ID-dependent variable 'tid' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-3]]:7 [opencl-possibly-unreachable-barrier]
+}
+
+void sync_helper() {
+  barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+void sync_if(int Value) {
+  if (Value < 16)
+    barrier(CLK_LOCAL_MEM_FENCE);
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Barrier inside if/else may not be reachable due to reference to ID-dependent variable 'Value' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-2]]:7 [opencl-possibly-unreachable-barrier]
+}
+
+__kernel void helper_errors() {
+  int tid = get_local_id(0);
+  if (tid < 16)
+    sync_helper();
+// CHECK-MESSAGES: :[[@LINE-1]]:5: warning: Call to 'sync_helper', which reaches a barrier, inside if/else may not be reachable due to reference to ID-dependent variable 'tid' in condition at {{(\/)?([^\/\0]+(\/)?)+}}:[[@LINE-2]]:7 [opencl-possibly-unreachable-barrier]
+  sync_if(tid);
+}
+
+__kernel void jump_correct(__global int *A) {
+  int tid = get_local_id(0);
+  if (get_local_size(0) < 16)
+    return;
+  for (int i = 0; i < 16; i++) {
+    if (A[0] == i)
+      break;
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  // All the work-items meet again after a divergent branch.
+  if (tid < 16)
+    A[tid] = 0;
+  else
+    A[tid] = 1;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  sync_helper();
+}
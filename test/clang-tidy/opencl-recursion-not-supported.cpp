@@ -4,7 +4,7 @@
 void recfun() {
   recfun();
   // CHECK-MESSAGES: :[[@LINE-1]]:3: error: The call to function recfun is recursive, which is not supported by OpenCL.
-  // CHECK-NEXT: recfun is called by recfun in {{.*:\d+:\d+}}
+  // CHECK-MESSAGES-NEXT: recfun is called by recfun in {{.*:[0-9]+:[0-9]+}}
 }
 
 // Declare functions first
@@ -29,9 +29,9 @@ void recfun2() {
 void recfun3() {
   recfun1();
   // CHECK-MESSAGES: :[[@LINE-1]]:3: error: The call to function recfun1 is recursive, which is not supported by OpenCL.
-  // CHECK-NEXT: recfun1 is called by recfun3 in {{.*:\d+:\d+}}
-  // CHECK-NEXT: recfun3 is called by recfun2 in {{.*:\d+:\d+}}
-  // CHECK-NEXT: recfun2 is called by recfun1 in {{.*:\d+:\d+}}
+  // CHECK-MESSAGES-NEXT: recfun1 is called by recfun3 in {{.*:[0-9]+:[0-9]+}}
+  // CHECK-MESSAGES-NEXT: recfun3 is called by recfun2 in {{.*:[0-9]+:[0-9]+}}
+  // CHECK-MESSAGES-NEXT: recfun2 is called by recfun1 in {{.*:[0-9]+:[0-9]+}}
 }
 
 // Non-recursive function should not trigger an error
@@ -55,3 +55,40 @@ void recfundeep3() {
 void recfundeep4() {
   recfundeep1();
 }
+
+// A cycle is reported once, however many calls close it.
+int fibonacci(int num) {
+  if (num < 2)
+    return 1;
+  return fibonacci(num - 2) + fibonacci(num - 1);
+  // CHECK-MESSAGES: :[[@LINE-1]]:10: error: The call to function fibonacci is recursive, which is not supported by OpenCL.
+  // CHECK-MESSAGES-NEXT: fibonacci is called by fibonacci in {{.*:[0-9]+:[0-9]+}}
+}
+
+// Calling a recursive function is not recursive in itself.
+int fibonacci_caller() {
+  return fibonacci(10);
+}
+
+// Functions that call each other through several cycles are reported once,
+// with the shortest cycle.
+void ping(int n);
+void pong(int n);
+void pang(int n);
+
+void ping(int n) {
+  pong(n - 1);
+  pang(n - 1);
+}
+
+void pong(int n) {
+  pang(n - 1);
+}
+
+void pang(int n) {
+  ping(n - 1);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: error: The call to function ping is recursive, which is not supported by OpenCL.
+  // CHECK-MESSAGES-NEXT: ping is called by pang in {{.*:[0-9]+:[0-9]+}}
+  // CHECK-MESSAGES-NEXT: pang is called by ping in {{.*:[0-9]+:[0-9]+}}
+  pong(n - 1);
+}
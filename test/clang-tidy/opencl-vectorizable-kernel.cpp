@@ -0,0 +1,88 @@
+// RUN: %check_clang_tidy %s opencl-vectorizable-kernel %t -- -header-filter=.* "--" -cl-std=CL1.2 -c --include opencl-c.h
+
+__attribute__((reqd_work_group_size(64, 1, 1)))
+__kernel void add(__global const float *A, __global const float *B,
+                  __global float *C) {
+// CHECK-MESSAGES: :[[@LINE-2]]:15: warning: kernel 'add' executes the same instructions in all work-items and accesses global memory contiguously; consider vectorizing it with num_simd_work_items(16) [opencl-vectorizable-kernel]
+// CHECK-FIXES: __attribute__((num_simd_work_items(16)))
+// CHECK-FIXES-NEXT: __attribute__((reqd_work_group_size(64, 1, 1)))
+  int i = get_global_id(0);
+  C[i] = A[i] + B[i];
+}
+
+__attribute__((reqd_work_group_size(24, 1, 1)))
+__kernel void add_24(__global const int *A, __global int *B) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'add_24' executes the same instructions in all work-items and accesses global memory contiguously; consider vectorizing it with num_simd_work_items(8) [opencl-vectorizable-kernel]
+  B[get_global_id(0)] += A[get_global_id(0)];
+}
+
+__kernel void saxpy(__global const float *X, __global float *Y, float Alpha) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'saxpy' executes the same instructions in all work-items and accesses global memory contiguously; consider vectorizing it with vec_type_hint(float4), or num_simd_work_items and a reqd_work_group_size that is a multiple of the SIMD width [opencl-vectorizable-kernel]
+  int i = get_global_id(0);
+  Y[i] = Alpha * X[i] + Y[i];
+}
+
+__kernel void scale(__global const float *In, __global float *Out) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'scale' executes the same
+  int i = get_global_id(0);
+  float4 V = (float4)(In[4 * i], In[4 * i + 1], In[4 * i + 2], In[4 * i + 3]);
+  // CHECK-MESSAGES: :[[@LINE-1]]:23: warning: 4 scalar loads from 'In' access consecutive elements; consider replacing them with a single vload4 [opencl-vectorizable-kernel]
+  vstore4(V * 2.0f, i, Out);
+}
+
+__kernel void split(__global const int2 *In, __global int *Out) {
+// CHECK-MESSAGES: :[[@LINE-1]]:15: warning: kernel 'split' executes the same
+  int i = get_global_id(0);
+  int2 Value = In[i];
+  Out[2 * i] = Value.x;
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 2 scalar stores to 'Out' access consecutive elements; consider replacing them with a single vstore2 [opencl-vectorizable-kernel]
+  Out[2 * i + 1] = Value.y;
+}
+
+// The work-items diverge.
+__attribute__((reqd_work_group_size(64, 1, 1)))
+__kernel void bounded(__global const float *A, __global float *B, int N) {
+  int i = get_global_id(0);
+  if (i < N)
+    B[i] = A[i];
+}
+
+// The accesses are strided.
+__kernel void strided(__global const float *A, __global float *B) {
+  int i = get_global_id(0);
+  B[i] = A[3 * i];
+}
+
+// The elements are not consecutive.
+__kernel void gaps(__global const float *In, __global float *Out) {
+  int i = get_global_id(0);
+  Out[i] = In[4 * i] + In[4 * i + 2];
+}
+
+// The work-items are serialized by the atomic.
+__kernel void count(__global const int *In, __global int *Count) {
+  if (In[get_global_id(0)] > 0)
+    atomic_inc(Count);
+}
+
+__kernel void histogram(__global const int *In, volatile __global int *Bins) {
+  atomic_inc(&Bins[In[get_global_id(0)]]);
+}
+
+// Already vectorized.
+__attribute__((num_simd_work_items(4)))
+__attribute__((reqd_work_group_size(64, 1, 1)))
+__kernel void simd(__global const float *A, __global float *B) {
+  B[get_global_id(0)] = A[get_global_id(0)];
+}
+
+__attribute__((vec_type_hint(float4)))
+__kernel void hinted(__global const float *A, __global float *B) {
+  B[get_global_id(0)] = A[get_global_id(0)];
+}
+
+// Single-work-item kernel.
+__kernel void loop(__global const float *A, __global float *B, int N) {
+  for (int i = 0; i < N; ++i)
+    B[i] = A[i];
+}